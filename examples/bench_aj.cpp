@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../include/kdb_cpp.h"
+
+////////////////////////////////////////////
+// As-of join benchmark on synthetic trades and quotes, no server needed
+// Usage: ./bench_aj [n_trades=10000000] [n_quotes=50000000] [n_syms=1000]
+////////////////////////////////////////////
+
+static K make_ticks(long long n, long long n_syms, K syms, long long seed, bool trades) {
+    K sym = ktn(KS, n);
+    K time = ktn(KP, n);
+    K px = ktn(KF, n);
+    unsigned long long x = static_cast<unsigned long long>(seed);
+    long long t = 0;
+    for (long long i = 0; i < n; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        t += 1 + static_cast<long long>(x >> 60);
+        kS(sym)[i] = kS(syms)[(x >> 33) % n_syms];
+        kJ(time)[i] = t;
+        kF(px)[i] = 100.0 + static_cast<double>((x >> 40) % 1000) / 100.0;
+    }
+    K header = ktn(KS, 3);
+    kS(header)[0] = ss(const_cast<S>("sym"));
+    kS(header)[1] = ss(const_cast<S>("time"));
+    kS(header)[2] = ss(const_cast<S>(trades ? "price" : "bid"));
+    return xT(xD(header, knk(3, sym, time, px)));
+}
+
+int main(int argc, char *argv[]) {
+    long long n_trades = argc > 1 ? std::atoll(argv[1]) : 10000000LL;
+    long long n_quotes = argc > 2 ? std::atoll(argv[2]) : 50000000LL;
+    long long n_syms = argc > 3 ? std::atoll(argv[3]) : 1000LL;
+
+    K syms = ktn(KS, n_syms);
+    for (long long i = 0; i < n_syms; ++i) {
+        kS(syms)[i] = ss(const_cast<S>(("SYM" + std::to_string(i)).c_str()));
+    }
+    kdb::Table trades = kdb::Result(make_ticks(n_trades, n_syms, syms, 1, true), false).get_table();
+    kdb::Table quotes = kdb::Result(make_ticks(n_quotes, n_syms, syms, 2, false), false).get_table();
+    r0(syms);
+
+    auto start = std::chrono::steady_clock::now();
+    kdb::Result joined = kdb::aj({"sym", "time"}, trades, quotes);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    kdb::Table tbl = joined.get_table();
+    std::cout << "aj `sym`time: " << n_trades << " x " << n_quotes << " rows, " << n_syms << " syms: "
+              << elapsed << " s, " << tbl.ncol() << " columns\n";
+
+    start = std::chrono::steady_clock::now();
+    joined = kdb::aj({"time"}, trades, quotes);
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "aj `time: " << elapsed << " s\n";
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/kdb_cpp.h"
+
+////////////////////////////////////////////
+// Round-trip latency of sync over TCP and Unix domain sockets to a local q (q -p port),
+// and over shared memory to an in-process ShmServer replying to every query
+// Usage: ./bench_transport [port=5000] [n=100000] > /dev/null
+////////////////////////////////////////////
+
+static void bench(const char *name, kdb::Connector &kcon, long long n) {
+    std::vector<double> us(static_cast<size_t>(n));
+    for (long long i = 0; i < n; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        kcon.sync("1");
+        us[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::sort(us.begin(), us.end());
+    std::cerr << name << ": p50 " << us[n / 2] << " us, p99 " << us[n * 99 / 100]
+              << " us, max " << us[n - 1] << " us\n";
+}
+
+int main(int argc, char *argv[]) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 5000;
+    long long n = argc > 2 ? std::atoll(argv[2]) : 100000LL;
+
+    kdb::Connector kcon;
+    if (kcon.connect("127.0.0.1", port)) {
+        bench("TCP", kcon, n);
+    }
+    if (kcon.connect(nullptr, port, nullptr, 1000, kdb::Transport::Unix)) {
+        bench("Unix", kcon, n);
+    }
+    kcon.disconnect();
+
+    // Shared memory peer on another port, so that it does not clash with q
+    kdb::ShmServer server(port + 1);
+    std::atomic<bool> stop(false);
+    std::thread peer([&]() {
+        while (!stop) {
+            server.serve([](K) { return kj(1); }, 100);
+        }
+    });
+    if (kcon.connect(nullptr, port + 1, nullptr, 1000, kdb::Transport::SharedMemory)) {
+        bench("Shared memory", kcon, n);
+    }
+    kcon.disconnect();
+    stop = true;
+    peer.join();
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+#include "../include/kdb_cpp.h"
+
+#define TP_ADDR "127.0.0.1"
+#define TP_PORT 5010
+#define RELAY_PORT 5011
+#define RELAY_IBM_PORT 5012
+
+// Rebroadcast a tickerplant to downstream q processes:
+//   all updates on port 5011, IBM trades only on port 5012, e.g., h:hopen 5012
+int main() {
+    kdb::Connector kcon;
+    if (!kcon.connect(TP_ADDR, TP_PORT))
+        return -1;
+    kcon.sync(".u.sub[`;`]");
+
+    kdb::Relay relay(kcon, 4096, kdb::SlowConsumer::DropOldest);
+    if (!relay.listen(RELAY_PORT) || !relay.listen(RELAY_IBM_PORT, kdb::Filter{{"trade"}, {"IBM"}}))
+        return -1;
+    relay.run();
+
+    kdb::Relay::Stats stats = relay.stats();
+    std::cout << "received " << stats.received << " forwarded " << stats.forwarded << " filtered " << stats.filtered
+              << " dropped " << stats.dropped << " disconnected " << stats.disconnected << '\n';
+    return 0;
+}
@@ -1,7 +1,12 @@
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <numeric>
 #include <type_traits>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "../include/kdb_cpp.h"
 
 #define HOST_ADDR "127.0.0.1"
@@ -80,6 +85,39 @@ void test_vector_accessor(kdb::Connector &kcon, const char *msg) {
     std::cout << '\n';
 }
 
+void test_thread_safe(kdb::Connector &kcon) {
+    // Share one result with a pool of workers without deep-copying it
+    kdb::set_thread_safe(true);
+    kdb::Result res = kcon.sync("([]a:til 100000;b:100000#1.0)");
+    if (res.struct_type() != kdb::StructType::Table) {
+        std::cout << "Error - result is not a table.\n";
+        kdb::set_thread_safe(false);
+        return;
+    }
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&failures, res]() {
+            for (int iter = 0; iter < 1000; ++iter) {
+                kdb::Result copy = res;
+                kdb::Table tbl = copy.get_table();
+                kdb::Vector<kdb::Type::Long> a = tbl.get_column<kdb::Type::Long>(0);
+                kdb::Vector<kdb::Type::Float> b = tbl.get_column<kdb::Type::Float>(1);
+                if (std::accumulate(a.begin(), a.end(), 0LL) != 4999950000LL ||
+                    std::accumulate(b.begin(), b.end(), 0.0) != 100000.0) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    std::cout << "Thread-safe stress test failures: " << failures << '\n';
+    kdb::set_thread_safe(false);
+}
+
 int main() {
     kdb::Connector kcon;
     if (!kcon.connect(HOST_ADDR, HOST_PORT))
@@ -267,6 +305,230 @@ int main() {
 
     char * cell6 = tbl.get<char *>(2, 2);
     std::cout << cell6 << '\n';
-        
+
+    ///////////////////////////////////////
+    // Test dictionary and keyed table accessors
+    ///////////////////////////////////////
+    kdb::Result dict_res = kcon.sync("`a`b`c!1 2 3");
+    if (dict_res.struct_type() == kdb::StructType::Dictionary) {
+        kdb::Dictionary dict = dict_res.get_dictionary();
+        std::cout << dict.size() << ": " << dict.get_keys() << "-> " << dict.get_values() << '\n';
+    }
+
+    kdb::Result keyed_res = kcon.sync("([sym:`a`b`c;date:2016.01.01 2016.01.02 2016.01.03]px:1.1 2.2 3.3f)");
+    if (keyed_res.struct_type() == kdb::StructType::KeyedTable) {
+        kdb::KeyedTable keyed = keyed_res.get_keyed_table();
+        keyed.build_index();
+        long long row = keyed.find("b", kcon.sync("2016.01.02").get<kdb::Type::Date>());
+        std::cout << "row " << row << " px " << keyed.get_values().get<kdb::Type::Float>(row, 0) << '\n';
+        std::cout << "missing key: " << keyed.find("d", 0) << '\n';
+    }
+
+    ///////////////////////////////////////
+    // Test attribute-aware lookups
+    ///////////////////////////////////////
+    kdb::Vector<kdb::Type::Long> sorted = kcon.sync("`s#0 0 10 10 20 20 30 30").get_vector<kdb::Type::Long>();
+    std::cout << "attribute " << static_cast<int>(sorted.attribute()) << " find 20: " << sorted.find(20)
+              << " bin 15: " << sorted.bin(15) << " within 10 20: " << sorted.within(10, 20).first
+              << ' ' << sorted.within(10, 20).second << '\n';
+    kdb::Vector<kdb::Type::Symbol> grouped = kcon.sync("`g#`b`a`b`c`a").get_vector<kdb::Type::Symbol>();
+    char sym_a[] = "a";
+    for (auto const &idx : grouped.where(sym_a)) {
+        std::cout << idx << ' ';
+    }
+    std::cout << '\n';
+
+    ///////////////////////////////////////
+    // Test client-side as-of join
+    ///////////////////////////////////////
+    kdb::Table aj_trades = kcon.sync("([]sym:`a`b`a;time:1 2 3;px:10.0 20.0 30.0)").get_table();
+    kdb::Table aj_quotes = kcon.sync("([]sym:`a`a;time:2 3;px:11.0 31.0;bid:9.0 29.0)").get_table();
+    // Unmatched rows keep px of the trade, like q aj: px 10 20 31, bid 0n 0n 29
+    std::cout << kdb::aj({"sym", "time"}, aj_trades, aj_quotes) << '\n';
+
+    ///////////////////////////////////////
+    // Test client-side query
+    ///////////////////////////////////////
+    kdb::Table trades = kcon.sync("([]sym:`a`b`a`c`b`a;px:1.0 2.0 3.0 4.0 5.0 6.0;sz:100 200 300 400 500 600)").get_table();
+    std::cout << kdb::Query(trades).where("px", kdb::Op::Gt, 1.5).where("sym", kdb::Op::Ne, "c").select({"sym", "sz"}).run() << '\n';
+    std::cout << kdb::Query(trades).by({"sym"}).agg(kdb::Agg::Sum, "sz").agg(kdb::Agg::Avg, "px")
+                 .agg(kdb::Agg::Last, "px", "last_px").agg(kdb::Agg::Count, "sz", "n").run() << '\n';
+    // No row matches: an empty keyed table
+    std::cout << kdb::Query(trades).where("px", kdb::Op::Gt, 100.0).by({"sym"}).agg(kdb::Agg::Sum, "sz").run() << '\n';
+
+    ///////////////////////////////////////
+    // Test functional select builder
+    ///////////////////////////////////////
+    kcon.sync("trade:([]sym:`a`b`a`c`b`a;px:1.0 2.0 3.0 4.0 5.0 6.0;sz:100 200 300 400 500 600)");
+    kdb::Select vwap("trade");
+    vwap.where(kdb::Col<kdb::Type::Symbol>("sym") != "c").where(kdb::col("px") > 1.5)
+        .by({"sym"})
+        .select("volume", kdb::agg(kdb::Agg::Sum, kdb::col("sz")))
+        .select("vwap", kdb::Expr::call("wavg", {kdb::col("sz"), kdb::col("px")}));
+    std::cout << vwap.run(kcon) << '\n';
+    std::cout << vwap.run(kcon) << '\n';     // same parse tree, not rebuilt
+
+    ///////////////////////////////////////
+    // Test function registry
+    ///////////////////////////////////////
+    kdb::FunctionRegistry fns(kcon);
+    fns.define("notional", "{[s] exec sum px*sz from trade where sym=s}");
+    for (const char *s : {"a", "b", "a"}) {
+        std::cout << fns.call("notional", {kdb::Result(ks(const_cast<S>(s)), false)}) << ' ';
+    }
+    std::cout << '\n' << fns.server_name("notional") << " installs " << fns.stats().installs
+              << " bytes saved " << fns.stats().bytes_saved << '\n';
+
+    ///////////////////////////////////////
+    // Test flattened string column
+    ///////////////////////////////////////
+    kdb::Table orders = kcon.sync("([]id:1 2 3;comment:(\"client urgent\";\"\";\"urgent: cancel\"))").get_table();
+    kdb::StringColumn comments(orders, orders.find_column("comment"));
+    for (long long i = 0; i < comments.size(); ++i) {
+        std::cout << '[' << comments[i] << "] ";
+    }
+    std::cout << "\nrows with 'urgent': ";
+    for (auto const &row : comments.contains("urgent")) {
+        std::cout << row << ' ';
+    }
+    std::cout << '\n';
+    kdb::ListColumn<kdb::Type::Boolean> flags(kcon.sync("(101b;0b;`boolean$())"));
+    std::cout << "flags " << flags.values().size() << " set " << std::count(flags.values().begin(), flags.values().end(), 1) << '\n';
+
+    ///////////////////////////////////////
+    // Test bulk conversion
+    ///////////////////////////////////////
+    std::vector<double> sizes = kdb::to_vector<double>(kcon.sync("1 0N 3i").get_vector<kdb::Type::Int>());
+    std::cout << sizes[0] << ' ' << sizes[1] << ' ' << sizes[2] << '\n';     // 1 nan 3
+    std::vector<double> features(trades.nrow() * 2);
+    kdb::to_matrix(trades, {trades.find_column("px"), trades.find_column("sz")}, features.data());
+    for (long long i = 0; i < trades.nrow(); ++i) {
+        std::cout << features[i * 2] << ',' << features[i * 2 + 1] << ' ';
+    }
+    std::cout << '\n';
+
+    ///////////////////////////////////////
+    // Test rolling windows
+    ///////////////////////////////////////
+    kdb::Vector<kdb::Type::Float> ticks = kcon.sync("1 2 0n 4 5 3f").get_vector<kdb::Type::Float>();
+    kdb::Vector<kdb::Type::Float> window = ticks.slice(1, 5);     // 2 0n 4 5
+    std::vector<double> mavg(ticks.size()), mmax(window.size());
+    kdb::rolling_mean(ticks, 3, mavg.data());
+    kdb::rolling_max(window, 2, mmax.data());
+    for (double v : mavg) std::cout << v << ' ';        // 1 1.5 1.5 3 4.5 4
+    std::cout << '\n';
+    for (double v : mmax) std::cout << v << ' ';        // 2 2 4 5
+    std::cout << '\n';
+    kdb::RollingMin<double> low(2);
+    low.update(3.0);
+    std::cout << low.update(1.0) << ' ' << low.update(2.0) << ' ' << low.update(4.0) << '\n';     // 1 1 2
+
+    ///////////////////////////////////////
+    // Test lazy remote table
+    ///////////////////////////////////////
+    kcon.sync("wide:([]a:til 5;b:5#1.5;c:`x`y`z`x`y;d:5#0b)");
+    kdb::RemoteTable wide(kcon, "wide");
+    std::cout << wide.nrow() << " rows, types " << wide.type(0) << wide.type(1) << wide.type(2) << wide.type(3) << '\n';
+    wide.hint({"b"});
+    std::cout << wide.column("a") << '\n';    // fetches a and b
+    std::cout << wide.rows(1, 3, {"b", "c"}) << '\n';
+    std::cout << "round trips " << wide.stats().round_trips << " columns fetched " << wide.stats().columns_fetched << '\n';
+
+    ///////////////////////////////////////
+    // Test snapshots
+    ///////////////////////////////////////
+    kcon.sync("ref:([]id:til 5;name:`a`b`c`d`e)");
+    kdb::save_snapshot(kcon.sync("ref"), "/tmp/ref.snap");
+    std::cout << kdb::load_snapshot("/tmp/ref.snap") << '\n';
+    kcon.sync("`ref insert (5 6;`f`g)");
+    std::cout << kdb::refresh_snapshot(kcon, "/tmp/ref.snap", "ref", "{select from ref where id>x}", "id") << '\n';
+
+    ///////////////////////////////////////
+    // Test symbol interning
+    ///////////////////////////////////////
+    kdb::Vector<kdb::Type::Symbol> syms = kcon.sync("`AAPL`MSFT`AAPL`IBM`IBM`MSFT").get_vector<kdb::Type::Symbol>();
+    std::vector<uint32_t> sym_ids = kdb::SymbolTable::global().intern(syms);
+    for (auto const &id : sym_ids) {
+        std::cout << id << ':' << kdb::SymbolTable::global().lookup(id) << ' ';
+    }
+    std::cout << '\n';
+    // IDs are stable across messages
+    std::cout << (kdb::SymbolTable::global().intern(kcon.sync("`IBM").get<kdb::Type::Symbol>()) == sym_ids[3]) << '\n';
+    // A reused buffer maps to the symbol it holds at each call
+    char sym_buf[8] = "IBM";
+    uint32_t ibm = kdb::SymbolTable::global().intern(sym_buf);
+    std::snprintf(sym_buf, sizeof(sym_buf), "XOM");
+    std::cout << (ibm == sym_ids[3]) << (kdb::SymbolTable::global().intern(sym_buf) != ibm) << '\n';
+
+    ///////////////////////////////////////
+    // Test parallel decode
+    ///////////////////////////////////////
+    kcon.set_parallel_decode(1 << 20);
+    kdb::Table big = kcon.sync("([]sym:1000000?`a`b`c;px:1000000?100f;sz:1000000?1000;id:til 1000000)").get_table();
+    kdb::Vector<kdb::Type::Long> ids = big.get_column<kdb::Type::Long>(3);
+    std::cout << "rows " << big.nrow() << " sum id " << std::accumulate(ids.begin(), ids.end(), 0LL) << '\n';
+    test_cout(kcon.sync("1+1`"));   // errors are reported the same way
+    kcon.set_parallel_decode(0);
+
+    ///////////////////////////////////////
+    // Test async queue
+    ///////////////////////////////////////
+    kcon.set_async_queue(1024, kdb::Backpressure::DropOldest);
+    for (int n = 0; n < 100; ++n) {
+        kcon.async("queued:1+til 10");
+    }
+    test_cout(kcon.sync("queued"));     // sync flushes the queue first
+    kdb::AsyncQueueStats queue_stats = kcon.async_queue_stats();
+    std::cout << "sent " << queue_stats.sent << " high water " << queue_stats.high_water
+              << " dropped " << queue_stats.dropped << '\n';
+    kcon.set_async_queue(0);
+
+    ///////////////////////////////////////
+    // Test reconnect
+    ///////////////////////////////////////
+    kdb::ReconnectPolicy policy;
+    policy.max_attempts = 5;
+    policy.standby = true;
+    policy.replay_sync = true;      // the query below may safely run twice
+    kcon.set_reconnect(policy);
+    // The server drops the connection the first time; the query is replayed on the standby
+    test_cout(kcon.sync("if[not `dropped in key `.; dropped::1b; hclose .z.w]; `replayed"));
+    kdb::ReconnectStats reconnect_stats = kcon.reconnect_stats();
+    std::cout << "reconnects " << reconnect_stats.reconnects << " standby swaps " << reconnect_stats.standby_swaps
+              << " replayed " << reconnect_stats.replayed << " failover us " << reconnect_stats.last_failover_us << '\n';
+    kcon.set_reconnect(kdb::ReconnectPolicy());
+
+    ///////////////////////////////////////
+    // Test function call and batch
+    ///////////////////////////////////////
+    test_cout(kcon.sync("{x+y}", {kdb::Result(kj(1), false), kdb::Result(kj(2), false)}));
+    kdb::Batch batch(kcon);
+    batch.add("count trades:([]sym:`a`b;px:1 2f)").add("1+`a").add("{x*y}", {kdb::Result(kj(6), false), kdb::Result(kj(7), false)});
+    if (batch.run()) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (batch.ok(i)) {
+                test_cout(batch.result(i));
+            } else {
+                std::cout << "item " << i << " failed: " << batch.error(i) << '\n';
+            }
+        }
+    }
+
+    ///////////////////////////////////////
+    // Test Unix domain socket transport
+    ///////////////////////////////////////
+    kdb::Connector local;
+    if (local.connect(nullptr, HOST_PORT, nullptr, 1000, kdb::Transport::Unix)) {
+        test_cout(local.sync("1+1"));
+        test_cout(local.sync("([]a:1 2 3;b:`x`y`z)"));
+        test_cout(local.sync("1+1`"));
+        local.disconnect();
+    }
+
+    ///////////////////////////////////////
+    // Test thread-safe mode
+    ///////////////////////////////////////
+    test_thread_safe(kcon);
+
     return 0;
 }
@@ -0,0 +1,195 @@
+/**
+ * @brief   Non-blocking asynchronous sends through a bounded queue and an I/O thread
+ *
+ * @file    kdb_async.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <sys/socket.h>
+#include "kdb_async.h"
+
+namespace kdb {
+    namespace internal {
+
+        // Messages per writev
+        constexpr size_t kBatch = 64;
+
+        bool writev_all(int fd, const iovec *iov, int n) {
+            std::vector<iovec> rest(iov, iov + n);
+            size_t first = 0;
+            while (first < rest.size()) {
+                msghdr msg = {};
+                msg.msg_iov = rest.data() + first;
+                msg.msg_iovlen = std::min<size_t>(rest.size() - first, IOV_MAX);
+                // sendmsg is writev with MSG_NOSIGNAL
+                ssize_t w = sendmsg(fd, &msg, MSG_NOSIGNAL);
+                if (w < 0 && errno == EINTR) {
+                    continue;
+                } else if (w <= 0) {
+                    return false;
+                }
+                size_t written = static_cast<size_t>(w);
+                while (first < rest.size() && written >= rest[first].iov_len) {
+                    written -= rest[first++].iov_len;
+                }
+                if (written > 0) {
+                    rest[first].iov_base = static_cast<char *>(rest[first].iov_base) + written;
+                    rest[first].iov_len -= written;
+                }
+            }
+            return true;
+        }
+
+        AsyncQueue::AsyncQueue(Writer writer, size_t capacity, Backpressure policy)
+            : writer_(std::move(writer)), capacity_(std::max<size_t>(capacity, 1)), policy_(policy) {
+            thread_ = std::thread([this]() { write_loop(); });
+        }
+
+        AsyncQueue::~AsyncQueue() {
+            flush();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            ready_.notify_all();
+            thread_.join();
+            for (K msg : queue_) {
+                r0(msg);
+            }
+            release_written();
+        }
+
+        void AsyncQueue::release_written() {
+            std::vector<K> written;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                written.swap(written_);
+            }
+            for (K msg : written) {
+                r0(msg);
+            }
+        }
+
+        bool AsyncQueue::push(K msg) {
+            release_written();
+            std::vector<K> dropped;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!failed_ && queue_.size() >= capacity_) {
+                    switch (policy_) {
+                    case Backpressure::Block:
+                        room_.wait(lock, [this]() { return failed_ || queue_.size() < capacity_; });
+                        break;
+                    case Backpressure::DropOldest:
+                        while (queue_.size() >= capacity_) {
+                            dropped.push_back(queue_.front());
+                            queue_.pop_front();
+                            ++stats_.dropped;
+                        }
+                        break;
+                    case Backpressure::Reject:
+                        break;
+                    }
+                }
+                if (failed_ || queue_.size() >= capacity_) {
+                    ++stats_.rejected;
+                    lock.unlock();
+                    dropped.push_back(msg);
+                    for (K x : dropped) {
+                        r0(x);
+                    }
+                    return false;
+                }
+                queue_.push_back(msg);
+                stats_.high_water = std::max(stats_.high_water, queue_.size() + in_flight_);
+            }
+            ready_.notify_one();
+            for (K x : dropped) {
+                r0(x);
+            }
+            return true;
+        }
+
+        bool AsyncQueue::flush() {
+            bool ok;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                room_.wait(lock, [this]() { return failed_ || (queue_.empty() && 0 == in_flight_); });
+                ok = !failed_;
+            }
+            release_written();
+            return ok;
+        }
+
+        void AsyncQueue::abort() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                failed_ = true;
+                stats_.rejected += queue_.size();
+                written_.insert(written_.end(), queue_.begin(), queue_.end());
+                queue_.clear();
+            }
+            room_.notify_all();
+            release_written();
+        }
+
+        AsyncQueueStats AsyncQueue::stats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            AsyncQueueStats stats = stats_;
+            stats.depth = queue_.size() + in_flight_;
+            return stats;
+        }
+
+        bool AsyncQueue::failed() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return failed_;
+        }
+
+        void AsyncQueue::write_loop() {
+            std::vector<K> batch;
+            std::vector<iovec> iov;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_.wait(lock, [this]() { return stopping_ || (!failed_ && !queue_.empty()); });
+                    if (stopping_) {
+                        return;
+                    }
+                    size_t n = std::min(queue_.size(), kBatch);
+                    batch.assign(queue_.begin(), queue_.begin() + n);
+                    queue_.erase(queue_.begin(), queue_.begin() + n);
+                    in_flight_ = n;
+                }
+                room_.notify_all();
+
+                iov.resize(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    iov[i].iov_base = kG(batch[i]);
+                    iov[i].iov_len = static_cast<size_t>(batch[i]->n);
+                }
+                bool ok = writer_(iov.data(), static_cast<int>(iov.size()));
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    written_.insert(written_.end(), batch.begin(), batch.end());
+                    in_flight_ = 0;
+                    if (ok) {
+                        stats_.sent += batch.size();
+                    } else {
+                        // The stream is broken: what is queued can never be sent
+                        failed_ = true;
+                        stats_.rejected += queue_.size() + batch.size();
+                        written_.insert(written_.end(), queue_.begin(), queue_.end());
+                        queue_.clear();
+                    }
+                }
+                batch.clear();
+                room_.notify_all();
+            }
+        }
+    }
+}
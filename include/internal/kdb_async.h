@@ -0,0 +1,134 @@
+/**
+ * @brief   Non-blocking asynchronous sends through a bounded queue and an I/O thread
+ *
+ * @file    kdb_async.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_ASYNC_H__
+#define __KDB_ASYNC_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+#include "../external/k.h"
+
+namespace kdb {
+
+    /**
+     * @brief   What an asynchronous send does when the queue is full
+     */
+    enum class Backpressure {
+        Block,          // wait for room
+        DropOldest,     // discard the oldest queued message
+        Reject          // do not queue, async() returns false
+    };
+
+    /**
+     * @brief   Asynchronous queue metrics
+     */
+    struct AsyncQueueStats {
+        size_t depth;                   // messages queued or being written
+        size_t high_water;              // largest depth seen
+        unsigned long long sent;
+        unsigned long long dropped;     // by Backpressure::DropOldest
+        unsigned long long rejected;    // by Backpressure::Reject, or after a write error
+    };
+
+    namespace internal {
+
+        /**
+         * @brief   Bounded queue of serialized messages, written by its own thread with
+         *          vectored writes. Messages are released on the producing thread, by push()
+         *          and flush(), never by the I/O thread.
+         *
+         *          The capacity bounds the messages waiting in the queue; the batch being
+         *          written, up to 64 messages, comes on top.
+         */
+        class AsyncQueue {
+        public:
+            /**
+             * @brief   Writes all buffers, returns false on error
+             */
+            typedef std::function<bool(const iovec *iov, int n)> Writer;
+
+            AsyncQueue(Writer writer, size_t capacity, Backpressure policy);
+
+            /**
+             * @brief   Flushes, then stops the I/O thread
+             */
+            ~AsyncQueue();
+
+            AsyncQueue(const AsyncQueue &) = delete;
+            AsyncQueue &operator=(const AsyncQueue &) = delete;
+
+            /**
+             * @brief       Queue a serialized message
+             *
+             * @param msg   byte vector holding the whole message, the queue takes it over
+             * @return true queued
+             * @return false    rejected, or the connection failed
+             */
+            bool push(K msg);
+
+            /**
+             * @brief   Wait until every queued message is written
+             *
+             * @return false    a write failed
+             */
+            bool flush();
+
+            /**
+             * @brief   Discard the queued messages without writing them and fail later
+             *          pushes, e.g., before the connection is closed. The batch being written
+             *          is not interrupted: shut the connection down first.
+             */
+            void abort();
+
+            AsyncQueueStats stats() const;
+
+            /**
+             * @brief   Whether a write failed, i.e., the connection is broken
+             */
+            bool failed() const;
+
+        private:
+            void write_loop();
+            void release_written();
+
+            Writer writer_;
+            size_t capacity_;
+            Backpressure policy_;
+            std::deque<K> queue_;
+            std::vector<K> written_;        // released by the producer
+            // Messages handed to the writer, not counted against capacity_: they cannot be dropped
+            size_t in_flight_ = 0;
+            bool stopping_ = false;
+            bool failed_ = false;
+            AsyncQueueStats stats_ = {0, 0, 0, 0, 0};
+            mutable std::mutex mutex_;
+            std::condition_variable ready_;     // message queued or stopping
+            std::condition_variable room_;      // messages written
+            std::thread thread_;
+        };
+
+        /**
+         * @brief       Write all buffers to a socket with writev, retrying on partial writes
+         *
+         * @return true if all bytes were written
+         */
+        bool writev_all(int fd, const iovec *iov, int n);
+    }
+}
+
+#endif // __KDB_ASYNC_H__
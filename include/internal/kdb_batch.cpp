@@ -0,0 +1,88 @@
+/**
+ * @brief   Many queries in one round trip to kdb+
+ *
+ * @file    kdb_batch.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include "../external/k.h"
+#include "kdb_column.h"
+#include "kdb_memory.h"
+#include "kdb_batch.h"
+
+namespace kdb {
+
+    // Each item evaluates to (::; value), or (`error; message) if it signals.
+    // :: never collapses into a simple vector, so every pair stays a mixed list.
+    static const char kEvaluate[] =
+        "{{@[{(::;$[10h=type x;value x;(value x 0) . x 1])};x;{(`error;x)}]} each x}";
+
+    Batch::Batch(Connector &kcon) : kcon_(kcon) {}
+
+    Batch &Batch::add(const char* query) {
+        items_.push_back(Result(kp(const_cast<S>(query)), false));
+        return *this;
+    }
+
+    Batch &Batch::add(const char* fn, const std::vector<Result> &args) {
+        items_.push_back(Result(knk(2, kp(const_cast<S>(fn)), internal::arg_list(args)), false));
+        return *this;
+    }
+
+    bool Batch::run() {
+        results_.assign(items_.size(), Result(nullptr));
+        errors_.assign(items_.size(), std::string());
+        failed_.assign(items_.size(), true);
+        if (items_.empty()) {
+            return true;
+        }
+
+        K list = ktn(0, static_cast<J>(items_.size()));
+        for (size_t i = 0; i < items_.size(); ++i) {
+            kK(list)[i] = internal::inc_ref(internal::Access::k(items_[i]));
+        }
+        Result reply = kcon_.sync(kEvaluate, {Result(list, false)});
+        K res = internal::Access::k(reply);
+        if (nullptr == res) {
+            for (auto &error : errors_) {
+                error = "batch failed";
+            }
+            return false;
+        } else if (res->t != 0 || res->n != static_cast<J>(items_.size())) {
+            fprintf(stderr, "[kdb+] Unexpected reply to a batch.\n");
+            for (auto &error : errors_) {
+                error = "unexpected reply";
+            }
+            return false;
+        }
+
+        for (size_t i = 0; i < items_.size(); ++i) {
+            K pair = kK(res)[i];
+            if (pair->t != 0 || pair->n != 2) {
+                errors_[i] = "unexpected reply";
+            } else if (101 == kK(pair)[0]->t) {
+                results_[i] = Result(kK(pair)[1]);
+                failed_[i] = false;
+            } else if (KC == kK(pair)[1]->t) {
+                errors_[i].assign(reinterpret_cast<const char *>(kC(kK(pair)[1])), static_cast<size_t>(kK(pair)[1]->n));
+            } else if (-KS == kK(pair)[1]->t) {
+                errors_[i] = kK(pair)[1]->s;
+            } else {
+                errors_[i] = "error";
+            }
+        }
+        return true;
+    }
+
+    void Batch::clear() {
+        items_.clear();
+        results_.clear();
+        errors_.clear();
+        failed_.clear();
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @brief   Many queries in one round trip to kdb+
+ *
+ * @file    kdb_batch.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_BATCH_H__
+#define __KDB_BATCH_H__
+
+#include <string>
+#include <vector>
+#include "kdb_connector.h"
+#include "kdb_result.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Collects independent queries and function calls, sends them as one message
+     *          and splits the reply. The server evaluates the items in order, trapping the
+     *          error of each item, so one failing item does not fail the others.
+     *
+     *          Batch batch(kcon);
+     *          batch.add("count trade").add("{x+y}", {Result(kj(1), false), Result(kj(2), false)});
+     *          if (batch.run()) { batch.result(0); batch.error(1); ... }
+     */
+    class Batch {
+    public:
+        Batch(Connector &kcon);
+
+        /**
+         * @brief       Add a query
+         *
+         * @param query q expression
+         * @return Batch&
+         */
+        Batch &add(const char* query);
+
+        /**
+         * @brief       Add a function call
+         *
+         * @param fn    function name or lambda
+         * @param args  arguments, none for a niladic function
+         * @return Batch&
+         */
+        Batch &add(const char* fn, const std::vector<Result> &args);
+
+        /**
+         * @brief   Number of items
+         */
+        inline size_t size() const { return items_.size(); }
+
+        /**
+         * @brief   Send all items in one synchronous message and wait for the reply.
+         *          Items are kept, so a batch can be run again.
+         *
+         * @return true     the batch was evaluated, items may still have failed
+         * @return false    the whole batch failed, e.g., network error
+         */
+        bool run();
+
+        /**
+         * @brief   Whether item i succeeded in the last run
+         */
+        inline bool ok(size_t i) const { return !failed_[i]; }
+
+        /**
+         * @brief   Result of item i in the last run, Result(nullptr) if it failed
+         */
+        inline const Result &result(size_t i) const { return results_[i]; }
+
+        /**
+         * @brief   Error message of item i in the last run, empty if it succeeded
+         */
+        inline const std::string &error(size_t i) const { return errors_[i]; }
+
+        /**
+         * @brief   Remove all items and results
+         */
+        void clear();
+
+    private:
+        Connector &kcon_;
+        std::vector<Result> items_;
+        std::vector<Result> results_;
+        std::vector<std::string> errors_;
+        std::vector<bool> failed_;
+    };
+}
+
+#endif // __KDB_BATCH_H__
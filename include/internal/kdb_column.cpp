@@ -0,0 +1,172 @@
+/**
+ * @brief   Helpers to build kdb+ columns and tables on the client side
+ *
+ * @file    kdb_column.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "kdb_memory.h"
+#include "kdb_parallel.h"
+#include "kdb_column.h"
+
+namespace kdb {
+    namespace internal {
+
+        int type_size(signed char t) {
+            switch (t) {
+            case 1: case 4: case 10:
+                return 1;
+            case 2:
+                return 16;
+            case 5:
+                return 2;
+            case 6: case 8: case 13: case 14: case 17: case 18: case 19:
+                return 4;
+            case 0: case 7: case 9: case 11: case 12: case 15: case 16:
+                return 8;
+            }
+            return 0;
+        }
+
+        template<typename V>
+        static void fill(K x, long long begin, long long end, V v) {
+            V *data = reinterpret_cast<V *>(kG(x));
+            std::fill(data + begin, data + end, v);
+        }
+
+        void fill_null(K x, long long begin, long long end) {
+            switch (x->t) {
+            case 1: case 4:
+                fill<G>(x, begin, end, 0); break;
+            case 2:
+                std::memset(kG(x) + begin * 16, 0, static_cast<size_t>(end - begin) * 16); break;
+            case 5:
+                fill<H>(x, begin, end, static_cast<H>(nh)); break;
+            case 6: case 13: case 14: case 17: case 18: case 19:
+                fill<I>(x, begin, end, ni); break;
+            case 7: case 12: case 16:
+                fill<J>(x, begin, end, nj); break;
+            case 8:
+                fill<E>(x, begin, end, static_cast<E>(nf)); break;
+            case 9: case 15:
+                fill<F>(x, begin, end, nf); break;
+            case 10:
+                fill<C>(x, begin, end, ' '); break;
+            case 11: {
+                static S null_sym = ss(const_cast<S>(""));
+                fill<S>(x, begin, end, null_sym); break;
+            }
+            }
+        }
+
+        template<typename V>
+        static void gather_range(K out, K col, const long long *rows, long long begin, long long end) {
+            V *dst = reinterpret_cast<V *>(kG(out));
+            const V *src = reinterpret_cast<const V *>(kG(col));
+            for (long long i = begin; i < end; ++i) {
+                if (rows[i] >= 0) {
+                    dst[i] = src[rows[i]];
+                } else {
+                    // Runs of misses are rare, null them one by one
+                    fill_null(out, i, i + 1);
+                }
+            }
+        }
+
+        K gather(K col, const long long *rows, long long n) {
+            K out = ktn(col->t, n);
+            switch (type_size(col->t)) {
+            case 0:
+                break;
+            case 1:
+                parallel_for(n, 1 << 16, [&](long long b, long long e) { gather_range<G>(out, col, rows, b, e); }); break;
+            case 2:
+                parallel_for(n, 1 << 16, [&](long long b, long long e) { gather_range<H>(out, col, rows, b, e); }); break;
+            case 4:
+                parallel_for(n, 1 << 16, [&](long long b, long long e) { gather_range<I>(out, col, rows, b, e); }); break;
+            case 8:
+                if (col->t == 0) {
+                    // Mixed list, e.g., strings: share the elements, reference counting stays on this thread
+                    signed char t = col->n > 0 ? kK(col)[0]->t : 0;
+                    for (long long i = 0; i < n; ++i) {
+                        kK(out)[i] = rows[i] >= 0 ? inc_ref(kK(col)[rows[i]]) : ktn(t > 0 && t < 20 ? t : 0, 0);
+                    }
+                } else {
+                    if (col->t == 11) {
+                        fill_null(out, 0, 0);   // pool the null symbol on this thread
+                    }
+                    parallel_for(n, 1 << 16, [&](long long b, long long e) { gather_range<J>(out, col, rows, b, e); });
+                }
+                break;
+            case 16:
+                for (long long i = 0; i < n; ++i) {
+                    if (rows[i] >= 0) {
+                        std::memcpy(kG(out) + i * 16, kG(col) + rows[i] * 16, 16);
+                    } else {
+                        fill_null(out, i, i + 1);
+                    }
+                }
+                break;
+            }
+            return out;
+        }
+
+        K slice(K col, long long begin, long long end) {
+            long long n = std::max(0LL, end - begin);
+            K out = ktn(col->t, n);
+            if (0 == col->t) {
+                for (long long i = 0; i < n; ++i) {
+                    kK(out)[i] = inc_ref(kK(col)[begin + i]);
+                }
+            } else if (n > 0) {
+                int size = type_size(col->t);
+                std::memcpy(kG(out), kG(col) + begin * size, static_cast<size_t>(n * size));
+            }
+            return out;
+        }
+
+        K concat(K a, K b) {
+            K out = ktn(a->t, a->n + b->n);
+            if (0 == a->t) {
+                for (long long i = 0; i < a->n; ++i) {
+                    kK(out)[i] = inc_ref(kK(a)[i]);
+                }
+                for (long long i = 0; i < b->n; ++i) {
+                    kK(out)[a->n + i] = inc_ref(kK(b)[i]);
+                }
+            } else {
+                size_t size = static_cast<size_t>(type_size(a->t));
+                std::memcpy(kG(out), kG(a), static_cast<size_t>(a->n) * size);
+                std::memcpy(kG(out) + a->n * size, kG(b), static_cast<size_t>(b->n) * size);
+            }
+            return out;
+        }
+
+        K make_table(const std::vector<S> &names, const std::vector<K> &cols) {
+            K header = ktn(11, static_cast<J>(names.size()));
+            K values = ktn(0, static_cast<J>(cols.size()));
+            for (size_t i = 0; i < names.size(); ++i) {
+                kS(header)[i] = names[i];
+                kK(values)[i] = cols[i];
+            }
+            return xT(xD(header, values));
+        }
+
+        K arg_list(const std::vector<Result> &args) {
+            K list = ktn(0, args.empty() ? 1 : static_cast<J>(args.size()));
+            for (J i = 0; i < list->n; ++i) {
+                K arg = static_cast<size_t>(i) < args.size() ? Access::k(args[i]) : nullptr;
+                if (arg != nullptr) {
+                    kK(list)[i] = inc_ref(arg);
+                } else {
+                    kK(list)[i] = ka(101);
+                    kK(list)[i]->g = 0;
+                }
+            }
+            return list;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @brief   Helpers to build kdb+ columns and tables on the client side
+ *
+ * @file    kdb_column.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_COLUMN_H__
+#define __KDB_COLUMN_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <vector>
+#include "../external/k.h"
+#include "kdb_type.h"
+#include "kdb_result.h"
+#include "kdb_table.h"
+#include "kdb_vector.h"
+
+namespace kdb {
+    namespace internal {
+
+        /**
+         * @brief   Access to the K objects behind the wrappers, for client-side algorithms
+         */
+        struct Access {
+            static inline K k(const Result &r) { return r.res_; }
+            static inline K k(const Table &t) { return t.res_; }
+            static inline K column(const Table &t, long long col) { return t.column(col); }
+
+            template<Type T>
+            static inline K k(const Vector<T> &v) { return v.res_; }
+
+            template<Type T>
+            static inline long long offset(const Vector<T> &v) { return v.offset_; }
+        };
+
+        /**
+         * @brief       Size in bytes of an element of a vector type
+         *
+         * @param t     vector type, 0 for a mixed list
+         * @return int  0 if t is not a vector type
+         */
+        int type_size(signed char t);
+
+        /**
+         * @brief       Set elements [begin, end) of a simple vector to the null of its type
+         */
+        void fill_null(K x, long long begin, long long end);
+
+        /**
+         * @brief       New column with col[rows[i]] for each i, or the null of the column type
+         *              where rows[i] < 0. Simple vectors are filled in parallel; elements of
+         *              mixed lists are shared, not copied.
+         *
+         * @param col   source column, a simple vector or a mixed list
+         * @param rows  row indexes into col
+         * @param n     number of rows
+         * @return K    new vector with reference count 0
+         */
+        K gather(K col, const long long *rows, long long n);
+
+        /**
+         * @brief       New column with elements [begin, end) of col. Simple vectors are copied,
+         *              elements of mixed lists are shared.
+         *
+         * @return K    new vector with reference count 0
+         */
+        K slice(K col, long long begin, long long end);
+
+        /**
+         * @brief       New column with the elements of a followed by those of b, of the same
+         *              type. Simple vectors are copied, elements of mixed lists are shared.
+         *
+         * @return K    new vector with reference count 0
+         */
+        K concat(K a, K b);
+
+        /**
+         * @brief       New table from column names and columns
+         *
+         * @param names pooled column names
+         * @param cols  columns of equal length; the table takes over one reference of each
+         * @return K    new table with reference count 0
+         */
+        K make_table(const std::vector<S> &names, const std::vector<K> &cols);
+
+        /**
+         * @brief       Arguments of a function call as a mixed list, each with a reference of
+         *              its own. A null Result becomes (::), and no arguments (enlist ::), so
+         *              that f . list calls a niladic f.
+         *
+         * @return K    new list with reference count 0
+         */
+        K arg_list(const std::vector<Result> &args);
+    }
+}
+
+#endif // __KDB_COLUMN_H__
@@ -10,8 +10,19 @@
 #define KXVER 3
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <sys/socket.h>
 #include "../external/k.h"
 #include "kdb_result.h"
+#include "kdb_column.h"
+#include "kdb_memory.h"
+#include "kdb_ipc.h"
 #include "kdb_connector.h"
 
 namespace kdb {
@@ -20,22 +31,39 @@ namespace kdb {
         disconnect();
     }
 
-    bool Connector::connect(const char* host, int port, const char* usr_pwd, int timeout) {
+    bool Connector::connect(const char* host, int port, const char* usr_pwd, int timeout, Transport transport) {
         host_ = host == nullptr ? "" : host;
         usr_pwd_ = usr_pwd == nullptr ? "" : usr_pwd;
         port_ = port;
+        timeout_ = timeout;
 
         // Disconnect the old connection if exists
-        if (hdl_ > 0) {
+        if (is_open()) {
             disconnect();
         }
+        close_handle(standby_hdl_);
+        standby_hdl_ = 0;
+        transport_ = transport;
 
-        if (timeout > 0) {
-            hdl_ = khpun(const_cast<const S>(host_.c_str()), port_, const_cast<const S>(usr_pwd_.c_str()), timeout);
-        } else {
-            hdl_ = khpu(const_cast<const S>(host_.c_str()), port_, const_cast<const S>(usr_pwd_.c_str()));
+        bool ok = open();
+        arm_standby();
+        return ok;
+    }
+
+    bool Connector::open() {
+        if (Transport::SharedMemory == transport_) {
+            shm_.reset(new internal::ShmChannel("/kx." + std::to_string(port_), false));
+            if (!shm_->valid()) {
+                shm_.reset();
+                fprintf(stderr, "[kdb+] Failed to connect to kdb+ server.\n");
+                return false;
+            }
+            fprintf(stdout, "[kdb+] Successfully connected to shared memory /kx.%d.\n", port_);
+            connected();
+            return true;
         }
-        fprintf(stdout, "[kdb+] Host IP: %s  Port: %d  Timeout: %d\n", host_.c_str(), port_, timeout);
+        hdl_ = open_handle(timeout_);
+        fprintf(stdout, "[kdb+] Host IP: %s  Port: %d  Timeout: %d\n", host_.c_str(), port_, timeout_);
         if (hdl_ < 0) {
             fprintf(stderr, "[kdb+] Failed to connect to kdb+ server.\n");
             return false;
@@ -44,12 +72,47 @@ namespace kdb {
             return false;
         }
         fprintf(stdout, "[kdb+] Successfully connected to %s.\n", host_.c_str());
+        connected();
         return true;
     }
 
+    void Connector::connected() {
+        static std::atomic<unsigned long long> next_id(0);
+        connection_id_ = ++next_id;
+        reconnectable_ = true;
+        want_standby_ = reconnect_policy_.standby;
+    }
+
+    int Connector::open_handle(int timeout) const {
+        if (Transport::Unix == transport_) {
+            return internal::connect_unix(port_, usr_pwd_.c_str(), timeout);
+        } else if (timeout > 0) {
+            return khpun(const_cast<const S>(host_.c_str()), port_, const_cast<const S>(usr_pwd_.c_str()), timeout);
+        }
+        return khpu(const_cast<const S>(host_.c_str()), port_, const_cast<const S>(usr_pwd_.c_str()));
+    }
+
+    void Connector::close_handle(int hdl) const {
+        if (hdl <= 0) {
+            return;
+        } else if (Transport::TCP == transport_) {
+            kclose(hdl);
+        } else {
+            close(hdl);
+        }
+    }
+
     void Connector::disconnect() {
-        if (hdl_ > 0) {
-            kclose(hdl_);
+        reconnectable_ = false;
+        want_standby_ = false;
+        close_handle(standby_hdl_);
+        standby_hdl_ = 0;
+        async_queue_.reset();   // flushes
+        if (shm_ != nullptr) {
+            shm_.reset();
+            fprintf(stdout, "[kdb+] Closed connection to shared memory /kx.%d.\n", port_);
+        } else if (hdl_ > 0) {
+            close_handle(hdl_);
             hdl_ = 0;
             fprintf(stdout, "[kdb+] Closed connection to %s.\n", host_.c_str());
         } else {
@@ -57,45 +120,334 @@ namespace kdb {
         }
     }
 
-    Result Connector::sync(const char* msg) {
-        if (hdl_ <= 0) {
-            fprintf(stderr, "[kdb+] Connection not established.\n");
-            // TODO auto connect
-            return Result(nullptr);
+    void Connector::set_reconnect(const ReconnectPolicy& policy) {
+        reconnect_policy_ = policy;
+        if (!policy.standby) {
+            close_handle(standby_hdl_);
+            standby_hdl_ = 0;
+        }
+        want_standby_ = policy.standby && reconnectable_;
+        arm_standby();
+    }
+
+    void Connector::drop() {
+        // Fail the write in flight at once rather than flush the queue to a peer that may
+        // be hung, which would stall the reconnect until TCP gives up
+        if (shm_ != nullptr) {
+            shm_->shutdown();
+        } else if (hdl_ > 0) {
+            ::shutdown(hdl_, SHUT_RDWR);
+        }
+        if (async_queue_ != nullptr) {
+            async_queue_->abort();
+        }
+        async_queue_.reset();
+        shm_.reset();
+        close_handle(hdl_);
+        hdl_ = 0;
+    }
+
+    bool Connector::reconnect() {
+        if (!reconnectable_ || reconnect_policy_.max_attempts <= 0) {
+            return false;
+        }
+        fprintf(stderr, "[kdb+] Connection lost. Reconnecting to %s:%d.\n", host_.c_str(), port_);
+        auto start = std::chrono::steady_clock::now();
+        drop();
+
+        bool ok = false;
+        if (standby_hdl_ > 0) {
+            // Swap in the standby at once; the next standby is opened after the request
+            hdl_ = standby_hdl_;
+            standby_hdl_ = 0;
+            ++reconnect_stats_.standby_swaps;
+            connected();
+            ok = true;
         } else {
-            fprintf(stdout, "[kdb+][sync] %s\n", msg);
-            K res = k(hdl_, const_cast<const S>(msg), (K)0);
-            if (nullptr == res) {
-                fprintf(stderr, "[kdb+] Network error. Failed to communicate with server.\n");
-            } else if (-128 == res->t) {
-                fprintf(stderr, "[kdb+] kdb+ syntax/command error : %s\n", res->s);
-                r0(res);   // Free memory if error as there is nothing useful in it
-                res = nullptr;
+            std::minstd_rand jitter(static_cast<unsigned>(start.time_since_epoch().count()));
+            int backoff = std::max(1, reconnect_policy_.initial_backoff_ms);
+            for (int attempt = 0; attempt < reconnect_policy_.max_attempts && !ok; ++attempt) {
+                if (attempt > 0) {
+                    // Between half and all of the backoff
+                    std::this_thread::sleep_for(std::chrono::milliseconds(backoff / 2 + jitter() % (backoff / 2 + 1)));
+                    backoff = std::min(backoff * 2, std::max(backoff, reconnect_policy_.max_backoff_ms));
+                }
+                ok = open();
             }
-            return Result(res, false);
         }
+
+        long long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        if (ok) {
+            ++reconnect_stats_.reconnects;
+            reconnect_stats_.last_failover_us = us;
+            reconnect_stats_.max_failover_us = std::max(reconnect_stats_.max_failover_us, us);
+        } else {
+            ++reconnect_stats_.failures;
+            fprintf(stderr, "[kdb+] Failed to reconnect after %d attempts.\n", reconnect_policy_.max_attempts);
+        }
+        return ok;
     }
 
-    void Connector::async(const char* msg) {
-        if (hdl_ <= 0) {
+    void Connector::arm_standby() {
+        if (!want_standby_) {
+            return;
+        }
+        want_standby_ = false;
+        if (Transport::SharedMemory == transport_ || hdl_ <= 0 || standby_hdl_ > 0) {
+            return;
+        }
+        int hdl = open_handle(timeout_);
+        standby_hdl_ = hdl > 0 ? hdl : 0;
+        if (0 == standby_hdl_) {
+            fprintf(stderr, "[kdb+] Failed to open a standby connection.\n");
+        }
+    }
+
+    bool Connector::request(const std::function<bool()>& send, bool replay) {
+        if (!is_open() && !reconnect()) {
             fprintf(stderr, "[kdb+] Connection not established.\n");
-            // TODO auto connect
-        } else {
-            fprintf(stdout, "[kdb+][async] %s\n", msg);
-            K res = k(-hdl_, const_cast<const S>(msg), (K)0);
-            if (nullptr == res) {
-                fprintf(stderr, "[kdb+] Network error. Failed to communicate with server.\n");
+            return false;
+        }
+        bool ok = send();
+        // Twice at most: an idle standby may have been closed by the server
+        for (int round = 0; !ok && round < 2 && reconnect(); ++round) {
+            if (!replay) {
+                break;
             }
+            ++reconnect_stats_.replayed;
+            ok = send();
         }
+        if (!ok) {
+            fprintf(stderr, "[kdb+] Network error. Failed to communicate with server.\n");
+        }
+        arm_standby();
+        return ok;
+    }
+
+    Result Connector::sync(const char* msg) {
+        fprintf(stdout, "[kdb+][sync] %s\n", msg);
+        K res = nullptr;
+        bool ok = request([&]() {
+            flush();    // keep queued async messages ahead of the request on the socket
+            if (raw()) {
+                K query = kp(const_cast<S>(msg));
+                res = sync_raw(query);
+                r0(query);
+            } else {
+                res = k(hdl_, const_cast<const S>(msg), (K)0);
+            }
+            return nullptr != res;
+        }, reconnect_policy_.replay_sync);
+        return ok ? to_result(res) : Result(nullptr);
+    }
+
+    Result Connector::sync(const char* fn, const std::vector<Result>& args) {
+        fprintf(stdout, "[kdb+][sync] %s[%zu args]\n", fn, args.size());
+        K res = nullptr;
+        bool ok = request([&]() {
+            flush();
+
+            // Apply fn to the argument list on the server, so any number of arguments goes
+            // through k() and the raw transports alike
+            K list = internal::arg_list(args);
+
+            static const char apply[] = "{(value x) . y}";
+            if (raw()) {
+                K query = knk(3, kp(const_cast<S>(apply)), kp(const_cast<S>(fn)), list);
+                res = sync_raw(query);
+                r0(query);
+            } else {
+                res = k(hdl_, const_cast<const S>(apply), kp(const_cast<S>(fn)), list, (K)0);
+            }
+            return nullptr != res;
+        }, reconnect_policy_.replay_sync);
+        return ok ? to_result(res) : Result(nullptr);
+    }
+
+    Result Connector::call(const char* fn, const std::vector<Result>& args) {
+        if (args.size() > 8) {
+            fprintf(stderr, "[kdb+] Too many arguments for %s: %zu.\n", fn, args.size());
+            return Result(nullptr);
+        }
+        fprintf(stdout, "[kdb+][call] %s[%zu args]\n", fn, args.size());
+        K res = nullptr;
+        bool ok = request([&]() {
+            flush();
+
+            K list = internal::arg_list(args);
+            if (raw()) {
+                // (`fn; x; y) is applied by the server without parsing anything
+                K query = ktn(0, list->n + 1);
+                kK(query)[0] = ks(const_cast<S>(fn));
+                for (J i = 0; i < list->n; ++i) {
+                    kK(query)[i + 1] = internal::inc_ref(kK(list)[i]);
+                }
+                r0(list);
+                res = sync_raw(query);
+                r0(query);
+            } else {
+                // .[`fn; (x; y)]: the server parses "." only
+                res = k(hdl_, const_cast<const S>("."), ks(const_cast<S>(fn)), list, (K)0);
+            }
+            return nullptr != res;
+        }, reconnect_policy_.replay_sync);
+        return ok ? to_result(res) : Result(nullptr);
+    }
+
+    Result Connector::to_result(K res) {
+        if (nullptr == res) {
+            fprintf(stderr, "[kdb+] Network error. Failed to communicate with server.\n");
+        } else if (-128 == res->t) {
+            fprintf(stderr, "[kdb+] kdb+ syntax/command error : %s\n", res->s);
+            r0(res);   // Free memory if error as there is nothing useful in it
+            res = nullptr;
+        }
+        return Result(res, false);
+    }
+
+    bool Connector::write_raw(K x, internal::MessageType type) {
+        K msg = internal::encode(x, type);
+        if (nullptr == msg) {
+            return false;
+        }
+        bool sent = shm_ != nullptr ? shm_->write(kG(msg), static_cast<size_t>(msg->n))
+                                    : internal::write_all(hdl_, kG(msg), static_cast<size_t>(msg->n));
+        r0(msg);
+        if (!sent) {
+            drop();     // possibly cut mid-message
+        }
+        return sent;
+    }
+
+    K Connector::read_raw(internal::Header &header) {
+        if (shm_ != nullptr) {
+            return internal::read_message([this](void *buf, size_t n) { return shm_->read(buf, n); }, header);
+        }
+        return internal::read_message(hdl_, header);
+    }
+
+    bool Connector::read_raw(void *buf, size_t n) {
+        return shm_ != nullptr ? shm_->read(buf, n) : internal::read_all(hdl_, buf, n);
+    }
+
+    K Connector::decode_raw(K msg) {
+        size_t min_parallel = parallel_decode_bytes_ > 0 ? static_cast<size_t>(parallel_decode_bytes_) : SIZE_MAX;
+        K res = internal::decode(msg, min_parallel, decode_threads_);
+        r0(msg);
+        return res;
+    }
+
+    K Connector::sync_raw(K query) {
+        if (!write_raw(query, internal::kSync)) {
+            return nullptr;
+        }
+
+        // Skip async messages the server may push before the response
+        internal::Header header;
+        K reply;
+        while (nullptr != (reply = read_raw(header)) && header.type != internal::kResponse) {
+            r0(reply);
+        }
+        if (nullptr == reply) {
+            drop();     // the rest of the message would be read as the next header
+            return nullptr;
+        }
+        return decode_raw(reply);
+    }
+
+    void Connector::set_parallel_decode(long long min_bytes, unsigned max_threads) {
+        parallel_decode_bytes_ = min_bytes > 0 ? min_bytes : 0;
+        decode_threads_ = max_threads;
+    }
+
+    bool Connector::async(const char* msg) {
+        fprintf(stdout, "[kdb+][async] %s\n", msg);
+        bool sent = false;
+        request([&]() {
+            if (async_capacity_ > 0) {
+                // A full queue rejecting the message is no reason to reconnect
+                sent = async_queued(msg);
+                return sent || !async_queue_->failed();
+            }
+            K res;
+            if (raw()) {
+                K query = kp(const_cast<S>(msg));
+                res = write_raw(query, internal::kAsync) ? query : nullptr;
+                r0(query);
+            } else {
+                res = k(-hdl_, const_cast<const S>(msg), (K)0);
+            }
+            sent = nullptr != res;
+            return sent;
+        }, reconnect_policy_.replay_async);
+        return sent;
+    }
+
+    bool Connector::async_queued(const char* msg) {
+        if (nullptr == async_queue_) {
+            internal::AsyncQueue::Writer writer;
+            if (shm_ != nullptr) {
+                internal::ShmChannel *shm = shm_.get();
+                writer = [shm](const iovec *iov, int n) {
+                    for (int i = 0; i < n; ++i) {
+                        if (!shm->write(iov[i].iov_base, iov[i].iov_len)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+            } else {
+                int fd = hdl_;
+                writer = [fd](const iovec *iov, int n) { return internal::writev_all(fd, iov, n); };
+            }
+            async_queue_.reset(new internal::AsyncQueue(writer, async_capacity_, async_policy_));
+        }
+
+        K query = kp(const_cast<S>(msg));
+        K serialized = internal::encode(query, internal::kAsync);
+        r0(query);
+        if (nullptr == serialized) {
+            return false;
+        } else if (!async_queue_->push(serialized)) {
+            fprintf(stderr, "[kdb+] Async message not queued: queue full or network error.\n");
+            return false;
+        }
+        return true;
+    }
+
+    void Connector::set_async_queue(size_t capacity, Backpressure policy) {
+        async_queue_.reset();
+        async_capacity_ = capacity;
+        async_policy_ = policy;
+    }
+
+    AsyncQueueStats Connector::async_queue_stats() const {
+        return async_queue_ != nullptr ? async_queue_->stats() : AsyncQueueStats{0, 0, 0, 0, 0};
+    }
+
+    bool Connector::flush() {
+        return nullptr == async_queue_ || async_queue_->flush();
     }
 
     // timeout in milliseconds
     Result Connector::receive(int timeout) {
+        // A timeout is no failure; a broken connection is dropped and reconnected, with
+        // nothing to replay
         K result = nullptr;
-        if (hdl_ <= 0) {
-            fprintf(stderr, "[kdb+] Connection not established.\n");
-            // TODO auto connect
-        } else {
+        request([&]() {
+            internal::Header header;
+            if (shm_ != nullptr) {
+                if (!shm_->readable(timeout)) {
+                    fprintf(stderr, "[kdb+] Error: no data within %d ms.\n", timeout);
+                    return true;
+                } else if (nullptr == (result = read_raw(header))) {
+                    drop();
+                    return false;
+                }
+                result = decode_raw(result);
+                return true;
+            }
+
             // Set timeout
             int retval;
             fd_set fds;
@@ -108,18 +460,26 @@ namespace kdb {
             retval = select(hdl_ + 1, &fds, NULL, NULL, &tv);
             if (retval == -1) {
                 fprintf(stderr, "[kdb+] Connection error.\n");
-                disconnect();
-            }
-
-            if (retval) {
-                if (FD_ISSET(hdl_, &fds)) {
-                    // Send an empty synchronous request to get the result
-                    result = k(hdl_, (S)0);
-                }
-            } else {
+                drop();
+                return false;
+            } else if (0 == retval || !FD_ISSET(hdl_, &fds)) {
                 fprintf(stderr, "[kdb+] Error: no data within %d ms.\n", timeout);
+                return true;
+            } else if (!raw()) {
+                // Send an empty synchronous request to get the result
+                result = k(hdl_, (S)0);
+                if (nullptr == result) {
+                    drop();
+                    return false;
+                }
+                return true;
+            } else if (nullptr == (result = read_raw(header))) {
+                drop();     // the peer closed, or the stream is cut mid-message
+                return false;
             }
-        }
+            result = decode_raw(result);
+            return true;
+        }, false);
 
         return Result(result, false);
     }
@@ -9,12 +9,50 @@
 #ifndef __KDB_CONNECTOR_H__
 #define __KDB_CONNECTOR_H__
 
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
+#include "../external/k.h"
+#include "kdb_async.h"
+#include "kdb_ipc.h"
+#include "kdb_transport.h"
 
 namespace kdb {
     class Result;
+    class Relay;
+
+    /**
+     * @brief   How a Connector recovers from a dropped connection
+     */
+    struct ReconnectPolicy {
+        int max_attempts = 0;           // connects tried per failure, 0 to disable (default)
+        int initial_backoff_ms = 50;    // wait before the second attempt, doubled after each
+        int max_backoff_ms = 2000;
+        // Keep a second connection open to swap in at once (not for shared memory). The next
+        // standby is opened at the end of the request that failed over, which pays its connect time.
+        bool standby = false;
+        // Resend a request whose reply was lost, which the server may have run already. Only
+        // for idempotent requests, e.g., reads: an insert or upsert would be applied twice.
+        bool replay_sync = false;       // sync() and call()
+        bool replay_async = false;
+    };
+
+    struct ReconnectStats {
+        unsigned long long reconnects;          // successful, standby swaps included
+        unsigned long long standby_swaps;
+        unsigned long long failures;            // all attempts failed
+        unsigned long long replayed;            // requests sent again after a reconnect
+        long long last_failover_us;             // from the failure to a new connection
+        long long max_failover_us;
+    };
 
     class Connector {
+        friend class Relay;
     public:
         ~Connector();
 
@@ -25,10 +63,12 @@ namespace kdb {
          * @param port      host port
          * @param usr_pwd   username:password
          * @param timeout   in milliseconds
+         * @param transport TCP, or Unix/SharedMemory to a process on this host (host is then ignored)
          * @return true     successfully connected to host:port
          * @return false    failed to connect to host:port
          */
-        bool connect(const char* host, int port, const char* usr_pwd=nullptr, int timeout=1000);
+        bool connect(const char* host, int port, const char* usr_pwd=nullptr, int timeout=1000,
+                     Transport transport=Transport::TCP);
 
         /**
          * @brief Disconnect from kdb+ server
@@ -43,12 +83,62 @@ namespace kdb {
          */
         Result sync(const char* msg);
 
+        /**
+         * @brief Call a function with arguments in one synchronous message, e.g.,
+         *        sync("{x+y}", {Result(kj(1), false), Result(kj(2), false)})
+         *
+         * @param fn    function name or lambda
+         * @param args  arguments, none for a niladic function
+         * @return Result
+         */
+        Result sync(const char* fn, const std::vector<Result>& args);
+
+        /**
+         * @brief Call a function defined on the server by name, e.g., call(".app.vwap", {sym}).
+         *        The message carries the name as a symbol instead of source to parse, applied
+         *        as is on the local transports and with . through k().
+         *
+         * @param fn    name of a global function
+         * @param args  at most 8 arguments, none for a niladic function
+         * @return Result
+         */
+        Result call(const char* fn, const std::vector<Result>& args);
+
+        /**
+         * @brief Identifier of the current connection, unique across connectors and changed
+         *        by every successful connect(), e.g., to tell that server state set on the
+         *        connection is gone. 0 if never connected.
+         */
+        inline unsigned long long connection_id() const { return connection_id_; }
+
         /**
          * @brief Send an asynchronous message/command
          * 
          * @param msg 
+         * @return true     sent, or queued if the async queue is enabled
+         * @return false    not sent
+         */
+        bool async(const char* msg);
+
+        /**
+         * @brief Queue async() messages instead of writing them on the calling thread. An I/O
+         *        thread drains the queue with vectored writes, so a slow server no longer
+         *        stalls the caller until the queue is full. sync() and disconnect() flush
+         *        the queue first, keeping messages in order.
+         *
+         * @param capacity  messages waiting at most, besides those being written; 0 to disable (default)
+         * @param policy    what async() does when the queue is full
+         */
+        void set_async_queue(size_t capacity, Backpressure policy=Backpressure::Block);
+
+        /**
+         * @brief Wait until every queued async message is written
+         *
+         * @return false    a write failed
          */
-        void async(const char* msg);
+        bool flush();
+
+        AsyncQueueStats async_queue_stats() const;
 
         /**
          * @brief Wait and receive from server
@@ -57,13 +147,73 @@ namespace kdb {
          * @return Result 
          */
         Result receive(int timeout=1000);
-        
+
+        /**
+         * @brief Decode large replies to sync() on several threads. Replies are then read from
+         *        the socket by the client rather than inside k(), and decoded in parallel
+         *        into their final buffers once they reach min_bytes.
+         *
+         * @param min_bytes     size of a reply, uncompressed, from which to decode in parallel,
+         *                      0 to disable (default)
+         * @param max_threads   0 for the number of hardware threads
+         */
+        void set_parallel_decode(long long min_bytes, unsigned max_threads=0);
+
+        /**
+         * @brief Reconnect when a request finds the connection closed or fails on a network
+         *        error, then resend the request if it may be replayed. Attempts back off
+         *        exponentially with jitter, so clients of a restarted server do not all
+         *        reconnect at once. receive() reconnects as well; server state tied to the old
+         *        connection, e.g., a subscription, is for the caller to restore when
+         *        connection_id() changes. Async messages still queued when the connection drops
+         *        are lost. No reconnect after disconnect() until the next connect().
+         *
+         * @param policy    max_attempts 0 disables reconnects
+         */
+        void set_reconnect(const ReconnectPolicy& policy);
+
+        inline const ReconnectPolicy& reconnect_policy() const { return reconnect_policy_; }
+        inline ReconnectStats reconnect_stats() const { return reconnect_stats_; }
 
     private:
+        // Messages go through c.o's k() unless the connection is local or decoded in parallel
+        inline bool raw() const { return transport_ != Transport::TCP || parallel_decode_bytes_ > 0; }
+        inline bool is_open() const { return hdl_ > 0 || shm_ != nullptr; }
+
+        bool write_raw(K x, internal::MessageType type);
+        K read_raw(internal::Header &header);
+        bool read_raw(void *buf, size_t n);
+        K decode_raw(K msg);     // releases msg
+        K sync_raw(K query);
+        bool async_queued(const char* msg);
+        Result to_result(K res);
+        bool open();
+        void connected();
+        int open_handle(int timeout) const;
+        void close_handle(int hdl) const;
+        void drop();
+        bool reconnect();
+        void arm_standby();
+        bool request(const std::function<bool()>& send, bool replay);
+
         std::string host_;
         std::string usr_pwd_;
         int port_ = 0;
+        int timeout_ = 1000;
         int hdl_ = 0;
+        int standby_hdl_ = 0;
+        bool want_standby_ = false;
+        bool reconnectable_ = false;    // connected, and not disconnected by the user since
+        ReconnectPolicy reconnect_policy_;
+        ReconnectStats reconnect_stats_ = {0, 0, 0, 0, 0, 0};
+        unsigned long long connection_id_ = 0;
+        long long parallel_decode_bytes_ = 0;
+        unsigned decode_threads_ = 0;
+        Transport transport_ = Transport::TCP;
+        std::unique_ptr<internal::ShmChannel> shm_;
+        size_t async_capacity_ = 0;
+        Backpressure async_policy_ = Backpressure::Block;
+        std::unique_ptr<internal::AsyncQueue> async_queue_;
     };
 }
 
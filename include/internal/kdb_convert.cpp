@@ -0,0 +1,168 @@
+/**
+ * @brief   Bulk conversion of kdb+ vectors and table columns to C++ numeric arrays
+ *
+ * @file    kdb_convert.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include "kdb_parallel.h"
+#include "kdb_convert.h"
+
+namespace kdb {
+    namespace internal {
+
+        // Elements per parallel chunk of a single vector, and rows per block of a matrix
+        constexpr long long kConvertGrain = 1 << 16;
+        // Elements per unrolled step: a trip count known at compile time vectorizes under the
+        // cheap cost model of -O2, which leaves loops needing a scalar epilogue alone
+        constexpr long long kLanes = 16;
+        constexpr long long kMatrixRows = 4096;
+
+        // How a source type marks nulls
+        enum class Nulls { None, Sentinel, NaN };
+
+        static bool convertible(signed char t) {
+            switch (t) {
+            case 1: case 4: case 5: case 6: case 7: case 8: case 9:
+            case 12: case 13: case 14: case 15: case 16: case 17: case 18: case 19:
+                return true;
+            }
+            return false;
+        }
+
+        // Value conversion, saturating when narrowing to an integer type. The lowest value of
+        // an integer type is its kdb+ null, so saturation stops one above it.
+        template<typename D, typename S>
+        static inline D cast(S x) {
+            if constexpr (std::is_floating_point<D>::value) {
+                return static_cast<D>(x);
+            } else if constexpr (std::is_floating_point<S>::value) {
+                constexpr D lo = std::numeric_limits<D>::min() + 1, hi = std::numeric_limits<D>::max();
+                return x <= static_cast<S>(lo) ? lo : (x >= static_cast<S>(hi) ? hi : static_cast<D>(x));
+            } else if constexpr (sizeof(S) < sizeof(D) || (sizeof(S) == sizeof(D) && std::is_signed<S>::value)) {
+                return static_cast<D>(x);
+            } else {
+                constexpr D lo = std::numeric_limits<D>::min() + 1, hi = std::numeric_limits<D>::max();
+                return x <= static_cast<S>(lo) ? lo : (x >= static_cast<S>(hi) ? hi : static_cast<D>(x));
+            }
+        }
+
+        // Branch-free loops over restrict pointers, so that the compiler vectorizes them;
+        // the unit-stride loop is kept apart as it vectorizes best
+        template<Nulls N, typename S, typename D>
+        static void convert_range(const S *__restrict src, D *__restrict out, long long n, long long stride,
+                                  S s_null, D null) {
+            auto value = [s_null, null](S x) {
+                if constexpr (N == Nulls::NaN) {
+                    return x != x ? null : cast<D>(x);
+                } else if constexpr (N == Nulls::Sentinel) {
+                    return x == s_null ? null : cast<D>(x);
+                } else {
+                    return cast<D>(x);
+                }
+            };
+            if (1 == stride) {
+                long long i = 0;
+                for (; i + kLanes <= n; i += kLanes) {
+                    for (long long j = 0; j < kLanes; ++j) {
+                        out[i + j] = value(src[i + j]);
+                    }
+                }
+                for (; i < n; ++i) {
+                    out[i] = value(src[i]);
+                }
+            } else {
+                for (long long i = 0; i < n; ++i) {
+                    out[i * stride] = value(src[i]);
+                }
+            }
+        }
+
+        // Convert elements [begin, end) of x into out[0], out[stride], ...
+        template<typename D>
+        static void convert_block(K x, long long begin, long long end, D *out, long long stride, D null) {
+            long long n = end - begin;
+            switch (x->t) {
+            case 1: case 4:
+                convert_range<Nulls::None>(kG(x) + begin, out, n, stride, G(0), null); break;
+            case 5:
+                convert_range<Nulls::Sentinel>(kH(x) + begin, out, n, stride, static_cast<H>(nh), null); break;
+            case 6: case 13: case 14: case 17: case 18: case 19:
+                convert_range<Nulls::Sentinel>(kI(x) + begin, out, n, stride, static_cast<I>(ni), null); break;
+            case 7: case 12: case 16:
+                convert_range<Nulls::Sentinel>(kJ(x) + begin, out, n, stride, static_cast<J>(nj), null); break;
+            case 8:
+                convert_range<Nulls::NaN>(kE(x) + begin, out, n, stride, E(0), null); break;
+            case 9: case 15:
+                convert_range<Nulls::NaN>(kF(x) + begin, out, n, stride, F(0), null); break;
+            }
+        }
+
+        template<typename D>
+        bool convert(K x, long long first, long long n, D *out, long long stride, D null) {
+            if (nullptr == x || !convertible(x->t)) {
+                fprintf(stderr, "[kdb+] Cannot convert type %d to a numeric array.\n", nullptr == x ? 0 : x->t);
+                return false;
+            }
+            parallel_for(n, kConvertGrain, [&](long long begin, long long end) {
+                convert_block(x, first + begin, first + end, out + begin * stride, stride, null);
+            });
+            return true;
+        }
+
+        template bool convert<float>(K, long long, long long, float *, long long, float);
+        template bool convert<double>(K, long long, long long, double *, long long, double);
+        template bool convert<short>(K, long long, long long, short *, long long, short);
+        template bool convert<int>(K, long long, long long, int *, long long, int);
+        template bool convert<long long>(K, long long, long long, long long *, long long, long long);
+    }
+
+    template<typename D>
+    bool convert(const Table &t, long long col, D *out, D null) {
+        if (col < 0 || col >= t.ncol()) {
+            fprintf(stderr, "[kdb+] No column %lld.\n", col);
+            return false;
+        }
+        return internal::convert<D>(internal::Access::column(t, col), 0, t.nrow(), out, 1, null);
+    }
+
+    template<typename D>
+    bool to_matrix(const Table &t, const std::vector<long long> &cols, D *out, D null) {
+        std::vector<K> columns;
+        for (long long col : cols) {
+            if (col < 0 || col >= t.ncol()) {
+                fprintf(stderr, "[kdb+] No column %lld.\n", col);
+                return false;
+            }
+            K x = internal::Access::column(t, col);
+            if (!internal::convertible(x->t)) {
+                fprintf(stderr, "[kdb+] Cannot convert column %lld of type %d to a numeric array.\n", col, x->t);
+                return false;
+            }
+            columns.push_back(x);
+        }
+
+        // A block of rows is written column by column with a stride, while it stays in cache
+        long long width = static_cast<long long>(columns.size());
+        internal::parallel_for(t.nrow(), internal::kMatrixRows, [&](long long begin, long long end) {
+            for (long long j = 0; j < width; ++j) {
+                internal::convert_block(columns[j], begin, end, out + begin * width + j, width, null);
+            }
+        });
+        return true;
+    }
+
+    template bool convert<float>(const Table &, long long, float *, float);
+    template bool convert<double>(const Table &, long long, double *, double);
+    template bool convert<short>(const Table &, long long, short *, short);
+    template bool convert<int>(const Table &, long long, int *, int);
+    template bool convert<long long>(const Table &, long long, long long *, long long);
+
+    template bool to_matrix<float>(const Table &, const std::vector<long long> &, float *, float);
+    template bool to_matrix<double>(const Table &, const std::vector<long long> &, double *, double);
+    template bool to_matrix<short>(const Table &, const std::vector<long long> &, short *, short);
+    template bool to_matrix<int>(const Table &, const std::vector<long long> &, int *, int);
+    template bool to_matrix<long long>(const Table &, const std::vector<long long> &, long long *, long long);
+}
@@ -0,0 +1,120 @@
+/**
+ * @brief   Bulk conversion of kdb+ vectors and table columns to C++ numeric arrays
+ *
+ * @file    kdb_convert.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_CONVERT_H__
+#define __KDB_CONVERT_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "../external/k.h"
+#include "kdb_type.h"
+#include "kdb_column.h"
+#include "kdb_table.h"
+#include "kdb_vector.h"
+
+namespace kdb {
+
+    /**
+     * @brief       Default replacement of kdb+ nulls: NaN for floating-point types, the kdb+
+     *              null (the lowest value, e.g., 0Ni) for integer types
+     *
+     * @tparam D    float, double, short, int or long long
+     */
+    template<typename D>
+    constexpr D null_value() {
+        if constexpr (std::is_floating_point<D>::value) {
+            return std::numeric_limits<D>::quiet_NaN();
+        } else {
+            return std::numeric_limits<D>::min();
+        }
+    }
+
+    namespace internal {
+
+        /**
+         * @brief       Convert elements [first, first + n) of a numeric or temporal vector into out[i * stride].
+         *              Nulls become null; floating-point values are rounded toward zero and
+         *              integers are saturated when narrowing to an integer type. Temporal types
+         *              convert their underlying count, e.g., nanoseconds of a timestamp.
+         *              Large vectors are converted in parallel.
+         *
+         * @tparam D    float, double, short, int or long long
+         * @param x     boolean, byte, short, int, long, real, float or temporal vector
+         * @param first first element
+         * @param n     number of elements
+         * @param out   at least (n - 1) * stride + 1 elements
+         * @param stride    distance between outputs, 1 for an array
+         * @param null  replacement of nulls
+         * @return false    unsupported type, e.g., symbol, GUID, char or mixed list
+         */
+        template<typename D>
+        bool convert(K x, long long first, long long n, D *out, long long stride, D null);
+    }
+
+    /**
+     * @brief       Convert a vector into a caller-provided buffer, e.g., Vector<Type::Int> to
+     *              double with NaN for 0Ni
+     *
+     * @tparam D    float, double, short, int or long long
+     * @param v     numeric or temporal vector
+     * @param out   at least v.size() elements
+     * @param null  replacement of nulls
+     */
+    template<typename D, Type T>
+    void convert(const Vector<T> &v, D *out, D null = null_value<D>()) {
+        static_assert(T != Type::Symbol && T != Type::Char, "symbols and chars do not convert to numbers");
+        internal::convert<D>(internal::Access::k(v), internal::Access::offset(v), v.size(), out, 1, null);
+    }
+
+    /**
+     * @brief       Convert a vector into a new std::vector
+     *
+     * @tparam D    float, double, short, int or long long
+     */
+    template<typename D, Type T>
+    std::vector<D> to_vector(const Vector<T> &v, D null = null_value<D>()) {
+        std::vector<D> out(static_cast<size_t>(v.size()));
+        convert<D>(v, out.data(), null);
+        return out;
+    }
+
+    /**
+     * @brief       Convert a table column into a caller-provided buffer
+     *
+     * @tparam D    float, double, short, int or long long
+     * @param t     table
+     * @param col   column index
+     * @param out   at least t.nrow() elements
+     * @param null  replacement of nulls
+     * @return false    no such column or unsupported column type
+     */
+    template<typename D>
+    bool convert(const Table &t, long long col, D *out, D null = null_value<D>());
+
+    /**
+     * @brief       Assemble columns of a table into a row-major matrix, e.g., a feature matrix
+     *              of nrow() x cols.size() doubles with NaN for nulls. Blocks of rows are
+     *              converted in parallel, each staying in cache while its columns are written.
+     *
+     * @tparam D    float, double, short, int or long long
+     * @param t     table
+     * @param cols  column indexes, in matrix column order
+     * @param out   at least t.nrow() * cols.size() elements; element (i, j) is out[i * cols.size() + j]
+     * @param null  replacement of nulls
+     * @return false    no such column or unsupported column type, out is left unspecified
+     */
+    template<typename D>
+    bool to_matrix(const Table &t, const std::vector<long long> &cols, D *out, D null = null_value<D>());
+}
+
+#endif // __KDB_CONVERT_H__
@@ -0,0 +1,39 @@
+/**
+ * @brief   C++ interface to read kdb+ dictionary and keyed table
+ *
+ * @file    kdb_dictionary.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <numeric>
+#include "kdb_dictionary.h"
+
+namespace kdb {
+    Dictionary::Dictionary(const Result &r) : res_(r) {}
+
+    long long Dictionary::size() const {
+        return get_keys().size();
+    }
+
+    Result Dictionary::get_keys() const {
+        return Result(kK(res_.res_)[0]);
+    }
+
+    Result Dictionary::get_values() const {
+        return Result(kK(res_.res_)[1]);
+    }
+
+    KeyedTable::KeyedTable(const Result &r) : res_(r),
+                                              keys_(Result(kK(r.res_)[0])),
+                                              values_(Result(kK(r.res_)[1])) {}
+
+    bool KeyedTable::build_index() const {
+        if (!index_) {
+            std::vector<long long> cols(static_cast<std::size_t>(keys_.ncol()));
+            std::iota(cols.begin(), cols.end(), 0LL);
+            index_ = std::make_shared<KeyIndex>(keys_, cols);
+        }
+        return index_->valid();
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @brief   C++ interface to read kdb+ dictionary and keyed table
+ *
+ * @file    kdb_dictionary.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_DICTIONARY_H__
+#define __KDB_DICTIONARY_H__
+
+#include <memory>
+#include <utility>
+#include "kdb_type.h"
+#include "kdb_result.h"
+#include "kdb_table.h"
+#include "kdb_index.h"
+
+namespace kdb {
+
+    class Dictionary {
+    public:
+        Dictionary(const Result &r);
+
+        /**
+         * @brief   Number of entries
+         */
+        long long size() const;
+
+        /**
+         * @brief   Get the keys, e.g., a vector of symbols
+         *
+         * @return  kdb::Result
+         */
+        Result get_keys() const;
+
+        /**
+         * @brief   Get the values, e.g., a vector or a mixed list
+         *
+         * @return  kdb::Result
+         */
+        Result get_values() const;
+
+    private:
+        Result res_;
+    };
+
+    class KeyedTable {
+    public:
+        KeyedTable(const Result &r);
+
+        /**
+         * @brief   Number of rows
+         */
+        inline long long nrow() const { return keys_.nrow(); }
+
+        /**
+         * @brief   Get the key columns as a table
+         *
+         * @return  kdb::Table
+         */
+        inline Table get_keys() const { return keys_; }
+
+        /**
+         * @brief   Get the value columns as a table
+         *
+         * @return  kdb::Table
+         */
+        inline Table get_values() const { return values_; }
+
+        /**
+         * @brief   Build the hash index over all key columns. Called by find() if not built yet;
+         *          call it up front to keep the build out of the first lookup, and before
+         *          looking up from several threads.
+         *
+         * @return  true if the key column types are supported, see KeyIndex
+         */
+        bool build_index() const;
+
+        /**
+         * @brief       Look up a row by key in O(1)
+         *
+         * @tparam Args integral, floating point, const char* or std::string, one per key column
+         * @param key   key values, in key column order
+         * @return long long    row index into get_keys() and get_values(), or -1 if not found
+         */
+        template<typename... Args>
+        long long find(const Args &... key) const;
+
+    private:
+        template<std::size_t... I, typename... Args>
+        long long find(std::index_sequence<I...>, const Args &... key) const;
+
+        Result res_;
+        Table keys_;
+        Table values_;
+        mutable std::shared_ptr<KeyIndex> index_;
+    };
+
+    template<typename... Args>
+    long long KeyedTable::find(const Args &... key) const {
+        static_assert(sizeof...(Args) > 0, "At least one key is required");
+        if (!build_index() || static_cast<std::size_t>(keys_.ncol()) != sizeof...(Args)) {
+            return -1;
+        }
+        return find(std::index_sequence_for<Args...>{}, key...);
+    }
+
+    template<std::size_t... I, typename... Args>
+    long long KeyedTable::find(std::index_sequence<I...>, const Args &... key) const {
+        const long long k[] = { index_->to_key(I, key)... };
+        long long group = index_->find(k);
+        return group < 0 ? -1 : index_->first_row(group);
+    }
+}
+
+#endif // __KDB_DICTIONARY_H__
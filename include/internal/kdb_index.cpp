@@ -0,0 +1,219 @@
+/**
+ * @brief   Hash index over one or more key columns of a kdb+ table
+ *
+ * @file    kdb_index.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include "kdb_index.h"
+
+namespace kdb {
+
+    static inline long long key_of_real(float e) {
+        if (e == 0) {
+            e = 0;          // -0e matches 0e
+        } else if (e != e) {
+            e = static_cast<float>(nf);   // a single NaN, i.e., the null
+        }
+        int bits;
+        std::memcpy(&bits, &e, sizeof(bits));
+        return bits;
+    }
+
+    static inline long long key_of_float(double f) {
+        if (f == 0) {
+            f = 0;
+        } else if (f != f) {
+            f = nf;
+        }
+        long long bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+
+    KeyIndex::KeyIndex(const Table &tbl, const std::vector<long long> &cols, const long long *rows, long long n)
+        : tbl_(tbl) {
+        for (auto const &c : cols) {
+            K data = tbl_.column(c);
+            Column col{data->t, data, {}};
+            switch (data->t) {
+            case 1: case 4: case 5: case 6: case 7: case 8: case 9: case 10: case 11:
+            case 12: case 13: case 14: case 15: case 16: case 17: case 18: case 19:
+                break;
+            case 0: // String column
+                col.pooled.resize(static_cast<std::size_t>(data->n));
+                for (long long row = 0; row < data->n; ++row) {
+                    K str = kK(data)[row];
+                    if (str->t != 10) {
+                        valid_ = false;
+                        break;
+                    }
+                    col.pooled[row] = reinterpret_cast<long long>(sn(reinterpret_cast<S>(kC(str)), static_cast<I>(str->n)));
+                }
+                break;
+            default:
+                valid_ = false;
+            }
+            if (!valid_) {
+                fprintf(stderr, "[kdb+] Unsupported key column type %d.\n", data->t);
+                return;
+            }
+            cols_.push_back(std::move(col));
+        }
+
+        // n < 0 indexes every row; a subset may be empty, and rows then null
+        const long long *subset = n >= 0 ? rows : nullptr;
+        if (n < 0) {
+            n = tbl_.nrow();
+        }
+        groups_.resize(static_cast<std::size_t>(n));
+        std::vector<long long> key(cols_.size());
+
+        if (cols_.size() == 1 && (cols_[0].data->u == 1 || cols_[0].data->u == 3)) {
+            // Equal keys are contiguous, a new group starts where the key changes
+            long long prev = 0;
+            for (long long i = 0; i < n; ++i) {
+                long long row = subset ? subset[i] : i;
+                long long k = cell(cols_[0], row);
+                if (i == 0 || k != prev) {
+                    first_rows_.push_back(row);
+                    prev = k;
+                }
+                groups_[i] = static_cast<uint32_t>(first_rows_.size() - 1);
+            }
+            std::size_t n_slots = 1024;
+            while (first_rows_.size() * 2 > n_slots) {
+                n_slots *= 2;
+            }
+            rehash(n_slots);
+            return;
+        }
+
+        rehash(1024);
+        for (long long i = 0; i < n; ++i) {
+            long long row = subset ? subset[i] : i;
+            this->key(row, key.data());
+            std::size_t mask = slots_.size() - 1;
+            std::size_t slot = hash(key.data()) & mask;
+            for (; slots_[slot]; slot = (slot + 1) & mask) {
+                if (equal(first_rows_[slots_[slot] - 1], key.data())) {
+                    break;
+                }
+            }
+            if (slots_[slot]) {
+                groups_[i] = slots_[slot] - 1;
+            } else {
+                groups_[i] = static_cast<uint32_t>(first_rows_.size());
+                first_rows_.push_back(row);
+                slots_[slot] = static_cast<uint32_t>(first_rows_.size());
+                // Keep load factor under 1/2, sized by distinct keys rather than rows
+                if (first_rows_.size() * 2 > slots_.size()) {
+                    rehash(slots_.size() * 2);
+                }
+            }
+        }
+    }
+
+    void KeyIndex::rehash(std::size_t n_slots) {
+        slots_.assign(n_slots, 0);
+        std::size_t mask = n_slots - 1;
+        std::vector<long long> key(cols_.size());
+        for (std::size_t group = 0; group < first_rows_.size(); ++group) {
+            this->key(first_rows_[group], key.data());
+            std::size_t i = hash(key.data()) & mask;
+            while (slots_[i]) {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = static_cast<uint32_t>(group + 1);
+        }
+    }
+
+    long long KeyIndex::cell(const Column &col, long long row) const {
+        K x = col.data;
+        switch (col.t) {
+        case 1: case 4: case 10:
+            return kG(x)[row];
+        case 5:
+            return kH(x)[row];
+        case 6: case 13: case 14: case 17: case 18: case 19:
+            return kI(x)[row];
+        case 7: case 12: case 16:
+            return kJ(x)[row];
+        case 8:
+            return key_of_real(kE(x)[row]);
+        case 9: case 15:
+            return key_of_float(kF(x)[row]);
+        case 11:
+            return reinterpret_cast<long long>(kS(x)[row]);
+        case 0:
+            return col.pooled[row];
+        }
+        return 0;
+    }
+
+    void KeyIndex::key(long long row, long long *key) const {
+        for (std::size_t c = 0; c < cols_.size(); ++c) {
+            key[c] = cell(cols_[c], row);
+        }
+    }
+
+    uint64_t KeyIndex::hash(const long long *key) const {
+        uint64_t h = 0x84222325CBF29CE4ULL;
+        for (std::size_t c = 0; c < cols_.size(); ++c) {
+            h = (h ^ static_cast<uint64_t>(key[c])) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 29;
+        }
+        return h;
+    }
+
+    bool KeyIndex::equal(long long row, const long long *key) const {
+        for (std::size_t c = 0; c < cols_.size(); ++c) {
+            if (cell(cols_[c], row) != key[c]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    long long KeyIndex::find(const long long *key) const {
+        if (!valid_) {
+            return -1;
+        }
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = hash(key) & mask; slots_[i]; i = (i + 1) & mask) {
+            if (equal(first_rows_[slots_[i] - 1], key)) {
+                return slots_[i] - 1;
+            }
+        }
+        return -1;
+    }
+
+    long long KeyIndex::key_of_integral(signed char t, long long value) const {
+        switch (t) {
+        case 8:
+            return key_of_real(static_cast<float>(value));
+        case 9: case 15:
+            return key_of_float(static_cast<double>(value));
+        }
+        return value;
+    }
+
+    long long KeyIndex::key_of_floating(signed char t, double value) const {
+        switch (t) {
+        case 8:
+            return key_of_real(static_cast<float>(value));
+        case 9: case 15:
+            return key_of_float(value);
+        }
+        return static_cast<long long>(value);
+    }
+
+    long long KeyIndex::key_of_string(signed char t, std::string_view value) const {
+        if (t == 10) {
+            return value.empty() ? ' ' : static_cast<unsigned char>(value[0]);
+        }
+        return reinterpret_cast<long long>(sn(const_cast<S>(value.data()), static_cast<I>(value.size())));
+    }
+}
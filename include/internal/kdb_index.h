@@ -0,0 +1,157 @@
+/**
+ * @brief   Hash index over one or more key columns of a kdb+ table
+ *
+ * @file    kdb_index.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_INDEX_H__
+#define __KDB_INDEX_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "../external/k.h"
+#include "kdb_type.h"
+#include "kdb_table.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Hash index mapping the distinct keys of one or more columns to dense group
+     *          IDs [0, ngroups()), in order of first appearance.
+     *
+     *          Supported key columns are boolean, byte, char, integral, temporal, real, float
+     *          and symbol vectors, as well as string (mixed list of char vectors) columns.
+     *          Every cell is reduced to a 64-bit key; symbols are keyed by their c.o pooled
+     *          pointer, strings are pooled with sn() while building.
+     */
+    class KeyIndex {
+    public:
+        /**
+         * @brief       Build the index over the given columns of a table
+         *
+         *              With a single key column that is sorted (s#) or parted (p#), rows are
+         *              grouped by runs of equal keys instead of hashing every row.
+         *
+         * @param tbl   table
+         * @param cols  key column indexes, one for a simple key, several for a compound key
+         * @param rows  ascending row indexes to index instead of all rows, e.g., a selection
+         * @param n     number of rows in rows, possibly 0; -1 to index all rows of the table
+         */
+        KeyIndex(const Table &tbl, const std::vector<long long> &cols, const long long *rows = nullptr, long long n = -1);
+
+        /**
+         * @brief   false if a key column has an unsupported type, in which case nothing is indexed
+         */
+        inline bool valid() const { return valid_; }
+
+        /**
+         * @brief   Number of indexed rows. Positions below are into the indexed rows, which are
+         *          table rows unless a row subset was given.
+         */
+        inline long long size() const { return static_cast<long long>(groups_.size()); }
+
+        /**
+         * @brief   Number of key columns
+         */
+        inline std::size_t width() const { return cols_.size(); }
+
+        /**
+         * @brief   Number of distinct keys
+         */
+        inline long long ngroups() const { return static_cast<long long>(first_rows_.size()); }
+
+        /**
+         * @brief       Group ID of an indexed row
+         *
+         * @param i     position [0, size())
+         * @return uint32_t
+         */
+        inline uint32_t group(long long i) const { return groups_[i]; }
+
+        /**
+         * @brief   Group IDs of all indexed rows
+         */
+        inline const std::vector<uint32_t> &groups() const { return groups_; }
+
+        /**
+         * @brief       First table row having the key of a group
+         *
+         * @param group group ID [0, ngroups())
+         * @return long long
+         */
+        inline long long first_row(long long group) const { return first_rows_[group]; }
+
+        /**
+         * @brief       Key of a table row in its 64-bit form
+         *
+         * @param row   table row index
+         * @param key   output of width() elements
+         */
+        void key(long long row, long long *key) const;
+
+        /**
+         * @brief       Look up a key in its 64-bit form
+         *
+         * @param key   width() elements, e.g., from key() of another index over columns of the same types
+         * @return long long    group ID, or -1 if not found
+         */
+        long long find(const long long *key) const;
+
+        /**
+         * @brief       Convert a C++ value to the 64-bit key form of a key column
+         *
+         * @tparam T    integral, floating point, const char*, std::string or std::string_view
+         * @param col   key column position [0, width())
+         * @param value value to look up
+         * @return long long
+         */
+        template<typename T>
+        long long to_key(std::size_t col, const T &value) const;
+
+    private:
+        struct Column {
+            signed char t;
+            K data;
+            std::vector<long long> pooled;      // pooled pointers of a string column
+        };
+
+        long long cell(const Column &col, long long row) const;
+        uint64_t hash(const long long *key) const;
+        bool equal(long long row, const long long *key) const;
+        void rehash(std::size_t n_slots);
+        long long key_of_integral(signed char t, long long value) const;
+        long long key_of_floating(signed char t, double value) const;
+        long long key_of_string(signed char t, std::string_view value) const;
+
+        Table tbl_;                             // keeps the indexed columns alive
+        std::vector<Column> cols_;
+        std::vector<uint32_t> groups_;          // group ID per row
+        std::vector<long long> first_rows_;     // first table row per group
+        std::vector<uint32_t> slots_;           // open addressing, group ID + 1, 0 if empty
+        bool valid_ = true;
+    };
+
+    template<typename T>
+    long long KeyIndex::to_key(std::size_t col, const T &value) const {
+        signed char t = cols_[col].t;
+        if constexpr (std::is_same<T, bool>::value || std::is_integral<T>::value) {
+            return key_of_integral(t, static_cast<long long>(value));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            return key_of_floating(t, static_cast<double>(value));
+        } else {
+            return key_of_string(t, std::string_view(value));
+        }
+    }
+}
+
+#endif // __KDB_INDEX_H__
@@ -0,0 +1,399 @@
+/**
+ * @brief   kdb+ IPC messages on raw sockets
+ *
+ * @file    kdb_ipc.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "kdb_column.h"
+#include "kdb_parallel.h"
+#include "kdb_ipc.h"
+
+namespace kdb {
+    namespace internal {
+
+        bool write_all(int fd, const void *buf, size_t n) {
+            const char *p = static_cast<const char *>(buf);
+            while (n > 0) {
+                // MSG_NOSIGNAL: a peer that went away is an error, not a SIGPIPE
+                ssize_t w = ::send(fd, p, n, MSG_NOSIGNAL);
+                if (w < 0 && errno == EINTR) {
+                    continue;
+                } else if (w <= 0) {
+                    return false;
+                }
+                p += w;
+                n -= static_cast<size_t>(w);
+            }
+            return true;
+        }
+
+        bool read_all(int fd, void *buf, size_t n) {
+            char *p = static_cast<char *>(buf);
+            while (n > 0) {
+                ssize_t r = ::read(fd, p, n);
+                if (r < 0 && errno == EINTR) {
+                    continue;
+                } else if (r <= 0) {
+                    return false;
+                }
+                p += r;
+                n -= static_cast<size_t>(r);
+            }
+            return true;
+        }
+
+        K encode(K x, MessageType type) {
+            K msg = b9(3, x);
+            if (nullptr == msg || msg->t != KG) {
+                if (msg != nullptr) {
+                    fprintf(stderr, "[kdb+] Failed to serialize message : %s\n", msg->t == -128 ? msg->s : "");
+                    r0(msg);
+                }
+                return nullptr;
+            }
+            kG(msg)[1] = static_cast<G>(type);
+            return msg;
+        }
+
+        K read_message(int fd, Header &header) {
+            return read_message([fd](void *buf, size_t n) { return read_all(fd, buf, n); }, header);
+        }
+
+        // Port of the decompression in kx's c.java
+        K decompress(const G *msg, size_t size) {
+            if (size < 12) {
+                return nullptr;
+            }
+            uint32_t n_out;
+            std::memcpy(&n_out, msg + 8, sizeof(n_out));
+            if (n_out < sizeof(Header)) {
+                return nullptr;
+            }
+
+            K res = ktn(KG, n_out);
+            G *dst = kG(res);
+            std::memcpy(dst, msg, sizeof(Header));
+            dst[2] = 0;
+            std::memcpy(dst + 4, &n_out, sizeof(n_out));
+
+            int aa[256] = {0};
+            size_t s = 8, p = 8, d = 12;
+            unsigned f = 0, i = 0;
+            while (s < n_out) {
+                if (0 == i) {
+                    if (d >= size) break;
+                    f = msg[d++];
+                    i = 1;
+                }
+                size_t n = 0;
+                if (f & i) {
+                    if (d + 2 > size) break;
+                    size_t r = static_cast<size_t>(aa[msg[d++]]);
+                    n = msg[d++];
+                    if (r >= s || s + 2 + n > n_out) break;
+                    dst[s++] = dst[r++];
+                    dst[s++] = dst[r++];
+                    for (size_t m = 0; m < n; ++m) {
+                        dst[s + m] = dst[r + m];    // may overlap, byte by byte
+                    }
+                } else {
+                    if (d >= size) break;
+                    dst[s++] = msg[d++];
+                }
+                while (p + 1 < s) {
+                    aa[dst[p] ^ dst[p + 1]] = static_cast<int>(p);
+                    ++p;
+                }
+                if (f & i) {
+                    p = s += n;
+                }
+                i = (i << 1) & 0xff;
+            }
+            if (s != n_out) {
+                fprintf(stderr, "[kdb+] Malformed compressed message.\n");
+                r0(res);
+                return nullptr;
+            }
+            return res;
+        }
+
+        const G *skip(const G *p, const G *end) {
+            if (p >= end) {
+                return nullptr;
+            }
+            signed char t = static_cast<signed char>(*p++);
+            if (-KS == t || -128 == t) {
+                const void *nul = std::memchr(p, 0, static_cast<size_t>(end - p));
+                return nullptr == nul ? nullptr : static_cast<const G *>(nul) + 1;
+            } else if (t < 0) {
+                int size = type_size(static_cast<signed char>(-t));
+                return 0 == size || end - p < size ? nullptr : p + size;
+            } else if (XT == t) {
+                return end - p < 1 ? nullptr : skip(p + 1, end);
+            } else if (XD == t || 127 == t) {
+                p = skip(p, end);
+                return nullptr == p ? nullptr : skip(p, end);
+            } else if (t > KT) {
+                return nullptr;
+            }
+
+            int n;
+            if (end - p < static_cast<long>(1 + sizeof(n))) {
+                return nullptr;
+            }
+            std::memcpy(&n, p + 1, sizeof(n));
+            p += 1 + sizeof(n);
+            if (n < 0) {
+                return nullptr;
+            } else if (0 == t) {
+                for (int i = 0; i < n && p != nullptr; ++i) {
+                    p = skip(p, end);
+                }
+                return p;
+            } else if (KS == t) {
+                for (int i = 0; i < n && p != nullptr; ++i) {
+                    const void *nul = std::memchr(p, 0, static_cast<size_t>(end - p));
+                    p = nullptr == nul ? nullptr : static_cast<const G *>(nul) + 1;
+                }
+                return p;
+            }
+            size_t bytes = static_cast<size_t>(n) * static_cast<size_t>(type_size(t));
+            return static_cast<size_t>(end - p) < bytes ? nullptr : p + bytes;
+        }
+
+        namespace {
+
+            // Bytes copied inline while building; larger vectors are queued for the workers
+            constexpr size_t kInlineCopy = 1 << 16;
+            // Bytes per worker task
+            constexpr size_t kChunk = 1 << 20;
+
+            struct Copy {
+                G *dst;
+                const G *src;
+                size_t bytes;
+            };
+
+            /**
+             * @brief   Builds the objects of a message on the calling thread and records the
+             *          copies of large vectors. Every read is bounds-checked; on anything
+             *          unexpected build() returns nullptr and the caller falls back to d9.
+             */
+            class Decoder {
+            public:
+                Decoder(const G *p, const G *end) : p_(p), end_(end) {}
+
+                K build() {
+                    if (p_ >= end_) {
+                        return nullptr;
+                    }
+                    signed char t = static_cast<signed char>(*p_++);
+                    if (t < 0) {
+                        return atom(t);
+                    } else if (t <= KT) {
+                        return vector(t);
+                    } else if (XT == t) {
+                        if (!skip(1) || p_ >= end_ || XD != static_cast<signed char>(*p_)) {
+                            return nullptr;
+                        }
+                        ++p_;
+                        K dict = dictionary();
+                        return nullptr == dict ? nullptr : xT(dict);
+                    } else if (XD == t) {
+                        return dictionary();
+                    }
+                    return nullptr;     // enumerations, functions, sorted dictionaries...
+                }
+
+                inline const G *position() const { return p_; }
+                inline std::vector<Copy> &copies() { return copies_; }
+
+            private:
+                inline bool skip(size_t n) {
+                    if (static_cast<size_t>(end_ - p_) < n) {
+                        return false;
+                    }
+                    p_ += n;
+                    return true;
+                }
+
+                // Null-terminated string at p_
+                inline S string() {
+                    const void *nul = std::memchr(p_, 0, static_cast<size_t>(end_ - p_));
+                    if (nullptr == nul) {
+                        return nullptr;
+                    }
+                    S s = ss(reinterpret_cast<S>(const_cast<G *>(p_)));
+                    p_ = static_cast<const G *>(nul) + 1;
+                    return s;
+                }
+
+                K atom(signed char t) {
+                    if (-KS == t || -128 == t) {
+                        S s = string();
+                        if (nullptr == s) {
+                            return nullptr;
+                        }
+                        K x = ka(t);
+                        x->s = s;
+                        return x;
+                    }
+                    int size = type_size(static_cast<signed char>(-t));
+                    if (0 == size || -UU == t || !skip(size)) {
+                        return nullptr;     // GUID atoms are not laid out like other atoms
+                    }
+                    K x = ka(t);
+                    std::memcpy(&x->g, p_ - size, size);
+                    return x;
+                }
+
+                K vector(signed char t) {
+                    G attr;
+                    int n;
+                    if (!skip(1 + sizeof(n))) {
+                        return nullptr;
+                    }
+                    attr = p_[-5];
+                    std::memcpy(&n, p_ - sizeof(n), sizeof(n));
+                    if (n < 0) {
+                        return nullptr;
+                    }
+
+                    if (0 == t) {
+                        // Each element is at least one byte: reject bogus lengths before allocating
+                        if (static_cast<size_t>(end_ - p_) < static_cast<size_t>(n)) {
+                            return nullptr;
+                        }
+                        K x = ktn(0, n);
+                        for (int i = 0; i < n; ++i) {
+                            K e = build();
+                            if (nullptr == e) {
+                                x->n = i;   // release only what was built
+                                r0(x);
+                                return nullptr;
+                            }
+                            kK(x)[i] = e;
+                        }
+                        x->u = attr;
+                        return x;
+                    } else if (KS == t) {
+                        if (static_cast<size_t>(end_ - p_) < static_cast<size_t>(n)) {
+                            return nullptr;
+                        }
+                        K x = ktn(KS, n);
+                        for (int i = 0; i < n; ++i) {
+                            S s = string();
+                            if (nullptr == s) {
+                                x->n = i;
+                                r0(x);
+                                return nullptr;
+                            }
+                            kS(x)[i] = s;
+                        }
+                        x->u = attr;
+                        return x;
+                    }
+
+                    size_t bytes = static_cast<size_t>(n) * static_cast<size_t>(type_size(t));
+                    if (!skip(bytes)) {
+                        return nullptr;
+                    }
+                    K x = ktn(t, n);
+                    x->u = attr;
+                    if (bytes < kInlineCopy) {
+                        std::memcpy(kG(x), p_ - bytes, bytes);
+                    } else {
+                        for (size_t off = 0; off < bytes; off += kChunk) {
+                            copies_.push_back(Copy{kG(x) + off, p_ - bytes + off, std::min(kChunk, bytes - off)});
+                        }
+                    }
+                    return x;
+                }
+
+                K dictionary() {
+                    K keys = build();
+                    if (nullptr == keys) {
+                        return nullptr;
+                    }
+                    K values = build();
+                    if (nullptr == values) {
+                        r0(keys);
+                        return nullptr;
+                    }
+                    return xD(keys, values);
+                }
+
+                const G *p_;
+                const G *end_;
+                std::vector<Copy> copies_;
+            };
+
+            // Decode on several threads, nullptr if c.o has to: big endian, unsupported type or
+            // trailing bytes
+            K decode_parallel(const G *msg, size_t size, unsigned max_threads) {
+                Decoder decoder(msg + sizeof(Header), msg + size);
+                K res = 1 == msg[0] ? decoder.build() : nullptr;
+                if (nullptr == res || decoder.position() != msg + size) {
+                    if (res != nullptr) {
+                        r0(res);    // queued copies are dropped
+                    }
+                    return nullptr;
+                }
+
+                std::vector<Copy> &copies = decoder.copies();
+                parallel_for(static_cast<long long>(copies.size()), 1, [&](long long b, long long e) {
+                    for (long long i = b; i < e; ++i) {
+                        std::memcpy(copies[i].dst, copies[i].src, copies[i].bytes);
+                    }
+                }, max_threads);
+                return res;
+            }
+        }
+
+        K decode(K msg, size_t min_parallel, unsigned max_threads) {
+            if (nullptr == msg || msg->n < static_cast<J>(sizeof(Header))) {
+                return nullptr;
+            }
+            const G *begin = kG(msg);
+            if (static_cast<size_t>(msg->n) < min_parallel || 1 != begin[0]) {
+                return d9(msg);
+            }
+            K res = decode_parallel(begin, static_cast<size_t>(msg->n), max_threads);
+            // msg is kdb+ memory already, c.o decodes it in place
+            return res != nullptr ? res : (okx(msg) ? d9(msg) : nullptr);
+        }
+
+        K decode(const G *msg, size_t size, unsigned max_threads) {
+            if (size < sizeof(Header)) {
+                return nullptr;
+            }
+            K res = decode_parallel(msg, size, max_threads);
+            if (res != nullptr) {
+                return res;
+            }
+            uint32_t declared;
+            std::memcpy(&declared, msg + 4, sizeof(declared));
+            if (1 != msg[0]) {
+                declared = __builtin_bswap32(declared);
+            }
+            if (declared != size) {
+                return nullptr;     // truncated
+            }
+            // c.o needs the bytes in kdb+ memory
+            K copy = ktn(KG, static_cast<J>(size));
+            std::memcpy(kG(copy), msg, size);
+            res = okx(copy) ? d9(copy) : nullptr;
+            r0(copy);
+            return res;
+        }
+    }
+}
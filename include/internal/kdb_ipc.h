@@ -0,0 +1,154 @@
+/**
+ * @brief   kdb+ IPC messages on raw sockets
+ *
+ * @file    kdb_ipc.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_IPC_H__
+#define __KDB_IPC_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../external/k.h"
+
+namespace kdb {
+    namespace internal {
+
+        /**
+         * @brief   kdb+ IPC message types, byte 1 of the header
+         */
+        enum MessageType {
+            kAsync = 0,
+            kSync = 1,
+            kResponse = 2
+        };
+
+        /**
+         * @brief   IPC message header
+         * @see     https://code.kx.com/q/basics/ipc/
+         */
+        struct Header {
+            uint8_t endian;         // 1 little endian
+            uint8_t type;           // MessageType
+            uint8_t compressed;
+            uint8_t reserved;
+            uint32_t size;          // including this header
+        };
+        static_assert(sizeof(Header) == 8, "kdb+ IPC header is 8 bytes");
+
+        /**
+         * @brief       Write all bytes to a socket, retrying on partial writes
+         *
+         * @return true if all bytes were written
+         */
+        bool write_all(int fd, const void *buf, size_t n);
+
+        /**
+         * @brief       Read exactly n bytes from a socket
+         *
+         * @return true if all bytes were read
+         */
+        bool read_all(int fd, void *buf, size_t n);
+
+        /**
+         * @brief       Serialize an object into a message
+         *
+         * @param x     object, e.g., kp("select from t") for a query
+         * @param type  MessageType
+         * @return K    byte vector holding the whole message, header included
+         */
+        K encode(K x, MessageType type);
+
+        /**
+         * @brief       Read one message from a socket, decompressing it if needed
+         *
+         * @param fd    socket
+         * @param header    header of the message as received
+         * @return K    byte vector holding the whole uncompressed message, or nullptr on network error
+         */
+        K read_message(int fd, Header &header);
+
+        /**
+         * @brief       Read one message from any byte stream, decompressing it if needed
+         *
+         * @param read  callable(void *buf, size_t n) -> bool, reading exactly n bytes
+         * @param header    header of the message as received
+         * @return K    byte vector holding the whole uncompressed message, or nullptr on error
+         */
+        template<typename Read>
+        K read_message(Read &&read, Header &header);
+
+        /**
+         * @brief       Decompress a message compressed by kdb+
+         *
+         * @param msg   whole compressed message
+         * @param size  size of msg in bytes
+         * @return K    byte vector holding the whole uncompressed message, or nullptr if malformed
+         */
+        K decompress(const G *msg, size_t size);
+
+        /**
+         * @brief       Skip one serialized object without decoding it
+         *
+         * @param p     first byte of the object, i.e., its type
+         * @param end   end of the message
+         * @return const G*     first byte after the object, nullptr if malformed or of a type
+         *                      that cannot be skipped (enumerations, functions)
+         */
+        const G *skip(const G *p, const G *end);
+
+        /**
+         * @brief       Deserialize a message. Messages of at least min_parallel bytes are
+         *              decoded in two passes: the structure is validated and every object is
+         *              allocated on the calling thread, then the bytes of fixed-width vectors
+         *              are copied into their final buffers by up to max_threads threads, in
+         *              chunks. Smaller messages, and messages holding types the decoder does
+         *              not handle (e.g., functions), go through d9.
+         *
+         * @param msg   byte vector holding the whole uncompressed message
+         * @param min_parallel  size in bytes from which to decode in parallel
+         * @param max_threads   0 for the number of hardware threads
+         * @return K    decoded object, nullptr if malformed
+         */
+        K decode(K msg, size_t min_parallel, unsigned max_threads = 0);
+
+        /**
+         * @brief       Deserialize a message held outside kdb+ memory, e.g., a mapped file,
+         *              always in parallel. Falls back to d9 on a copy.
+         *
+         * @param msg   whole uncompressed message
+         * @param size  size of msg in bytes
+         * @param max_threads   0 for the number of hardware threads
+         * @return K    decoded object, nullptr if malformed
+         */
+        K decode(const G *msg, size_t size, unsigned max_threads = 0);
+
+        template<typename Read>
+        K read_message(Read &&read, Header &header) {
+            if (!read(&header, sizeof(Header)) || header.size < sizeof(Header)) {
+                return nullptr;
+            }
+            K msg = ktn(KG, header.size);
+            std::memcpy(kG(msg), &header, sizeof(Header));
+            if (!read(kG(msg) + sizeof(Header), header.size - sizeof(Header))) {
+                r0(msg);
+                return nullptr;
+            }
+            if (header.compressed) {
+                K raw = decompress(kG(msg), header.size);
+                r0(msg);
+                msg = raw;
+            }
+            return msg;
+        }
+    }
+}
+
+#endif // __KDB_IPC_H__
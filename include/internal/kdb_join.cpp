@@ -0,0 +1,275 @@
+/**
+ * @brief   Client-side joins over kdb+ tables
+ *
+ * @file    kdb_join.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include "kdb_column.h"
+#include "kdb_index.h"
+#include "kdb_memory.h"
+#include "kdb_parallel.h"
+#include "kdb_join.h"
+
+namespace kdb {
+
+    namespace {
+        // Rows of one key group, in table order
+        struct Groups {
+            std::vector<long long> offsets;     // group g owns rows[offsets[g], offsets[g + 1])
+            std::vector<long long> rows;
+        };
+
+        Groups group_rows(const KeyIndex &index) {
+            Groups groups;
+            groups.offsets.assign(static_cast<size_t>(index.ngroups()) + 1, 0);
+            for (auto const &g : index.groups()) {
+                ++groups.offsets[g + 1];
+            }
+            for (size_t g = 1; g < groups.offsets.size(); ++g) {
+                groups.offsets[g] += groups.offsets[g - 1];
+            }
+            std::vector<long long> next(groups.offsets.begin(), groups.offsets.end() - 1);
+            groups.rows.resize(static_cast<size_t>(index.size()));
+            for (long long row = 0; row < index.size(); ++row) {
+                groups.rows[next[index.group(row)]++] = row;
+            }
+            return groups;
+        }
+
+        // A slice of left rows to match against the rows of one right group
+        struct Task {
+            const long long *left_rows;     // nullptr: left rows are [left_begin, left_end)
+            long long left_begin;
+            long long left_end;
+            const long long *right_rows;    // nullptr: right rows are [0, n_right)
+            long long n_right;
+        };
+
+        template<typename V>
+        void match_task(const Task &task, const V *left_time, const V *right_time, long long *match) {
+            auto right_at = [&](long long j) {
+                return right_time[task.right_rows ? task.right_rows[j] : j];
+            };
+
+            long long pos = -1;     // last matched position in the right group, -1 if none
+            V prev = V();
+            for (long long i = task.left_begin; i < task.left_end; ++i) {
+                long long row = task.left_rows ? task.left_rows[i] : i;
+                V t = left_time[row];
+                if (i > task.left_begin && t < prev) {
+                    pos = -1;       // out of order, search from the start
+                }
+                prev = t;
+
+                // Gallop forward from the previous match, then bisect the last step
+                long long lo = pos, step = 1;
+                while (lo + step < task.n_right && !(t < right_at(lo + step))) {
+                    lo += step;
+                    step <<= 1;
+                }
+                long long hi = std::min(lo + step, task.n_right);
+                while (hi - lo > 1) {
+                    long long mid = lo + (hi - lo) / 2;
+                    if (t < right_at(mid)) {
+                        hi = mid;
+                    } else {
+                        lo = mid;
+                    }
+                }
+                pos = lo;
+
+                if (pos < 0) {
+                    match[row] = -1;
+                } else {
+                    match[row] = task.right_rows ? task.right_rows[pos] : pos;
+                }
+            }
+        }
+
+        template<typename V>
+        void match_all(const std::vector<Task> &tasks, K left_time, K right_time, long long *match) {
+            const V *lt = reinterpret_cast<const V *>(kG(left_time));
+            const V *rt = reinterpret_cast<const V *>(kG(right_time));
+            internal::parallel_for(static_cast<long long>(tasks.size()), 1, [&](long long begin, long long end) {
+                for (long long i = begin; i < end; ++i) {
+                    match_task<V>(tasks[i], lt, rt, match);
+                }
+            });
+        }
+
+        const long long kTaskRows = 1 << 16;
+
+        template<typename V>
+        void overwrite_range(K out, K col, const long long *match, long long begin, long long end) {
+            V *dst = reinterpret_cast<V *>(kG(out));
+            const V *src = reinterpret_cast<const V *>(kG(col));
+            for (long long i = begin; i < end; ++i) {
+                if (match[i] >= 0) {
+                    dst[i] = src[match[i]];
+                }
+            }
+        }
+
+        // Copy of the left column with the matched rows taken from the right column, like q aj
+        K overwrite(K left_col, K right_col, const long long *match, long long n) {
+            K out = internal::slice(left_col, 0, n);
+            switch (internal::type_size(out->t)) {
+            case 1:
+                internal::parallel_for(n, kTaskRows, [&](long long b, long long e) { overwrite_range<G>(out, right_col, match, b, e); }); break;
+            case 2:
+                internal::parallel_for(n, kTaskRows, [&](long long b, long long e) { overwrite_range<H>(out, right_col, match, b, e); }); break;
+            case 4:
+                internal::parallel_for(n, kTaskRows, [&](long long b, long long e) { overwrite_range<I>(out, right_col, match, b, e); }); break;
+            case 8:
+                if (0 == out->t) {
+                    // Mixed list: reference counting stays on this thread
+                    for (long long i = 0; i < n; ++i) {
+                        if (match[i] >= 0) {
+                            internal::dec_ref(kK(out)[i]);
+                            kK(out)[i] = internal::inc_ref(kK(right_col)[match[i]]);
+                        }
+                    }
+                } else {
+                    internal::parallel_for(n, kTaskRows, [&](long long b, long long e) { overwrite_range<J>(out, right_col, match, b, e); });
+                }
+                break;
+            case 16:
+                for (long long i = 0; i < n; ++i) {
+                    if (match[i] >= 0) {
+                        std::memcpy(kG(out) + i * 16, kG(right_col) + match[i] * 16, 16);
+                    }
+                }
+                break;
+            }
+            return out;
+        }
+
+        void add_tasks(std::vector<Task> &tasks, const long long *left_rows, long long begin, long long end,
+                       const long long *right_rows, long long n_right) {
+            for (long long b = begin; b < end; b += kTaskRows) {
+                tasks.push_back(Task{left_rows, b, std::min(end, b + kTaskRows), right_rows, n_right});
+            }
+        }
+    }
+
+    bool aj_index(const std::vector<std::string> &cols, const Table &left, const Table &right, long long *match) {
+        if (cols.empty()) {
+            fprintf(stderr, "[kdb+] aj requires a time column.\n");
+            return false;
+        }
+        std::vector<long long> left_cols, right_cols;
+        for (auto const &name : cols) {
+            long long lc = left.find_column(name.c_str());
+            long long rc = right.find_column(name.c_str());
+            if (lc < 0 || rc < 0) {
+                fprintf(stderr, "[kdb+] aj column %s not found.\n", name.c_str());
+                return false;
+            }
+            if (internal::Access::column(left, lc)->t != internal::Access::column(right, rc)->t) {
+                fprintf(stderr, "[kdb+] aj column %s has different types.\n", name.c_str());
+                return false;
+            }
+            left_cols.push_back(lc);
+            right_cols.push_back(rc);
+        }
+        K left_time = internal::Access::column(left, left_cols.back());
+        K right_time = internal::Access::column(right, right_cols.back());
+        left_cols.pop_back();
+        right_cols.pop_back();
+
+        // Split the work into (left slice, right group) tasks
+        std::vector<Task> tasks;
+        Groups left_groups, right_groups;
+        if (left_cols.empty()) {
+            add_tasks(tasks, nullptr, 0, left.nrow(), nullptr, right.nrow());
+        } else {
+            KeyIndex left_index(left, left_cols);
+            KeyIndex right_index(right, right_cols);
+            if (!left_index.valid() || !right_index.valid()) {
+                return false;
+            }
+            left_groups = group_rows(left_index);
+            right_groups = group_rows(right_index);
+
+            std::vector<long long> key(left_cols.size());
+            for (long long g = 0; g < left_index.ngroups(); ++g) {
+                const long long *left_rows = left_groups.rows.data();
+                long long begin = left_groups.offsets[g], end = left_groups.offsets[g + 1];
+                left_index.key(left_index.first_row(g), key.data());
+                long long rg = right_index.find(key.data());
+                if (rg < 0) {
+                    for (long long i = begin; i < end; ++i) {
+                        match[left_rows[i]] = -1;
+                    }
+                    continue;
+                }
+                long long right_begin = right_groups.offsets[rg];
+                add_tasks(tasks, left_rows, begin, end, right_groups.rows.data() + right_begin,
+                          right_groups.offsets[rg + 1] - right_begin);
+            }
+        }
+
+        switch (left_time->t) {
+        case 5:
+            match_all<H>(tasks, left_time, right_time, match); break;
+        case 6: case 13: case 14: case 17: case 18: case 19:
+            match_all<I>(tasks, left_time, right_time, match); break;
+        case 7: case 12: case 16:
+            match_all<J>(tasks, left_time, right_time, match); break;
+        case 8:
+            match_all<E>(tasks, left_time, right_time, match); break;
+        case 9: case 15:
+            match_all<F>(tasks, left_time, right_time, match); break;
+        default:
+            fprintf(stderr, "[kdb+] Unsupported aj time column type %d.\n", left_time->t);
+            return false;
+        }
+        return true;
+    }
+
+    Result aj(const std::vector<std::string> &cols, const Table &left, const Table &right) {
+        std::vector<long long> match(static_cast<size_t>(left.nrow()));
+        if (!aj_index(cols, left, right, match.data())) {
+            return Result(nullptr);
+        }
+
+        std::vector<S> names;
+        std::vector<K> columns;
+        K left_header = kK(internal::Access::k(left)->k)[0];
+        for (long long c = 0; c < left.ncol(); ++c) {
+            names.push_back(kS(left_header)[c]);
+            columns.push_back(internal::inc_ref(internal::Access::column(left, c)));
+        }
+
+        K right_header = kK(internal::Access::k(right)->k)[0];
+        for (long long c = 0; c < right.ncol(); ++c) {
+            S name = kS(right_header)[c];
+            if (std::find(cols.begin(), cols.end(), name) != cols.end()) {
+                continue;
+            }
+            K right_col = internal::Access::column(right, c);
+            long long lc = left.find_column(name);
+            if (lc < 0) {
+                names.push_back(name);
+                columns.push_back(internal::gather(right_col, match.data(), left.nrow()));
+                continue;
+            }
+            if (columns[lc]->t != right_col->t) {
+                fprintf(stderr, "[kdb+] aj column %s has different types.\n", name);
+                for (auto const &col : columns) {
+                    internal::dec_ref(col);
+                }
+                return Result(nullptr);
+            }
+            K col = overwrite(columns[lc], right_col, match.data(), left.nrow());
+            internal::dec_ref(columns[lc]);
+            columns[lc] = col;
+        }
+        return Result(internal::make_table(names, columns), false);
+    }
+}
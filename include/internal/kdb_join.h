@@ -0,0 +1,54 @@
+/**
+ * @brief   Client-side joins over kdb+ tables
+ *
+ * @file    kdb_join.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_JOIN_H__
+#define __KDB_JOIN_H__
+
+#include <string>
+#include <vector>
+#include "kdb_result.h"
+#include "kdb_table.h"
+
+namespace kdb {
+
+    /**
+     * @brief       Match every row of left with the last row of right having the same keys
+     *              and a time <= the time of the left row, like the row matching of q aj.
+     *
+     *              Rows of right must be in ascending time order within each key, e.g., a
+     *              quote table sorted by time. Rows of left may come in any order, ascending
+     *              time within each key is the fast path. Key groups are matched in parallel
+     *              with a galloping search.
+     *
+     * @param cols  key column names followed by the time column name, e.g., {"sym", "time"}
+     * @param left  left table, e.g., trades
+     * @param right right table, e.g., quotes
+     * @param match output of left.nrow() elements: matched row of right, or -1 if none
+     * @return true     success
+     * @return false    missing column, mismatched column types or unsupported key type
+     */
+    bool aj_index(const std::vector<std::string> &cols, const Table &left, const Table &right, long long *match);
+
+    /**
+     * @brief       As-of join like q aj[cols; left; right]
+     *
+     *              The result has the columns of left, followed by the columns of right that
+     *              are not in left, null on unmatched rows. Like q, the other columns of right
+     *              that are also in left overwrite them on matched rows only, unmatched rows keep
+     *              the value of left. Columns of left not in right are shared, not copied.
+     *
+     * @param cols  key column names followed by the time column name, e.g., {"sym", "time"}
+     * @param left  left table, e.g., trades
+     * @param right right table, e.g., quotes
+     * @return Result   joined table, or Result(nullptr) on error, e.g., a column in both
+     *                  tables with different types
+     */
+    Result aj(const std::vector<std::string> &cols, const Table &left, const Table &right);
+}
+
+#endif // __KDB_JOIN_H__
@@ -0,0 +1,54 @@
+/**
+ * @brief   Flattened views of nested kdb+ columns, e.g., strings
+ *
+ * @file    kdb_list.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include "kdb_list.h"
+
+namespace kdb {
+
+    std::vector<long long> StringColumn::contains(std::string_view needle) const {
+        std::vector<long long> rows;
+        std::string_view buffer(values_.data(), values_.size());
+        long long n = size();
+        if (needle.empty()) {
+            for (long long row = 0; row < n; ++row) {
+                rows.push_back(row);
+            }
+            return rows;
+        }
+
+        long long row = 0;
+        for (size_t pos = buffer.find(needle); pos != std::string_view::npos; pos = buffer.find(needle, pos)) {
+            // Row holding pos; offsets only grow, so search forward from the last row
+            row = std::upper_bound(offsets_.begin() + row, offsets_.end(), static_cast<long long>(pos)) - offsets_.begin() - 1;
+            if (row >= n) {
+                break;
+            }
+            long long end = offsets_[row + 1];
+            if (static_cast<long long>(pos + needle.size()) <= end) {
+                rows.push_back(row);
+                pos = static_cast<size_t>(end);     // one hit per row is enough
+                ++row;
+            } else {
+                ++pos;                              // straddles two rows, keep looking
+            }
+        }
+        return rows;
+    }
+
+    std::vector<long long> StringColumn::equal(std::string_view str) const {
+        std::vector<long long> rows;
+        for (long long row = 0; row < size(); ++row) {
+            if (offsets_[row + 1] - offsets_[row] == static_cast<long long>(str.size()) &&
+                std::memcmp(values_.data() + offsets_[row], str.data(), str.size()) == 0) {
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+}
@@ -0,0 +1,163 @@
+/**
+ * @brief   Flattened views of nested kdb+ columns, e.g., strings
+ *
+ * @file    kdb_list.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_LIST_H__
+#define __KDB_LIST_H__
+
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "kdb_type.h"
+#include "kdb_result.h"
+#include "kdb_column.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Mixed list of typed vectors flattened into one contiguous values buffer
+     *          plus an offsets array, filled in a single copy pass. Row i is
+     *          values()[offsets()[i], offsets()[i + 1]).
+     *
+     *          Atoms in the list are taken as one-element rows, so a column mixing
+     *          "ab" and "c" (a char atom) flattens as expected. Rows of another type are
+     *          taken as empty and counted by mismatched().
+     *
+     * @tparam T    kdb::Type of the nested vectors
+     */
+    template<Type T>
+    class ListColumn {
+    public:
+        // Booleans are held as bytes, 0 or 1: std::vector<bool> has no data()
+        typedef typename std::conditional<T == Type::Boolean, unsigned char, typename c_type<T>::type>::type value_type;
+
+        /**
+         * @brief   A row of the column, pointing into the flattened buffer
+         */
+        struct Row {
+            const value_type *first;
+            const value_type *last;
+
+            inline const value_type *begin() const { return first; }
+            inline const value_type *end() const { return last; }
+            inline long long size() const { return last - first; }
+            inline const value_type &operator[](long long i) const { return first[i]; }
+        };
+
+        /**
+         * @brief       Flatten a mixed list. Undefined behavior if the result is not a mixed list.
+         *
+         * @param r     mixed list
+         */
+        ListColumn(const Result &r) { flatten(internal::Access::k(r)); }
+
+        /**
+         * @brief       Flatten a column of a table. Undefined behavior if the column is not a mixed list.
+         *
+         * @param tbl   table
+         * @param col   column index
+         */
+        ListColumn(const Table &tbl, long long col) { flatten(internal::Access::column(tbl, col)); }
+
+        /**
+         * @brief   Number of rows
+         */
+        inline long long size() const { return static_cast<long long>(offsets_.size()) - 1; }
+
+        inline Row operator[](long long i) const {
+            return Row{values_.data() + offsets_[i], values_.data() + offsets_[i + 1]};
+        }
+
+        /**
+         * @brief   Flattened values of all rows
+         */
+        inline const std::vector<value_type> &values() const { return values_; }
+
+        /**
+         * @brief   size() + 1 offsets into values(), the first one is 0
+         */
+        inline const std::vector<long long> &offsets() const { return offsets_; }
+
+        /**
+         * @brief   Number of rows that were not of type T
+         */
+        inline long long mismatched() const { return mismatched_; }
+
+    protected:
+        void flatten(K list);
+
+        std::vector<value_type> values_;
+        std::vector<long long> offsets_;
+        long long mismatched_ = 0;
+    };
+
+    /**
+     * @brief   String column, i.e., a mixed list of char vectors, flattened
+     */
+    class StringColumn : public ListColumn<Type::Char> {
+    public:
+        StringColumn(const Result &r) : ListColumn<Type::Char>(r) {}
+        StringColumn(const Table &tbl, long long col) : ListColumn<Type::Char>(tbl, col) {}
+
+        /**
+         * @brief   Row i as a string view into the flattened buffer
+         */
+        inline std::string_view operator[](long long i) const {
+            return std::string_view(values_.data() + offsets_[i], static_cast<size_t>(offsets_[i + 1] - offsets_[i]));
+        }
+
+        /**
+         * @brief       Rows containing a substring, in ascending order. The whole buffer is
+         *              scanned at once with memchr/memcmp rather than row by row.
+         *
+         * @param needle    substring, an empty one matches every row
+         * @return std::vector<long long>
+         */
+        std::vector<long long> contains(std::string_view needle) const;
+
+        /**
+         * @brief       Rows equal to a string, in ascending order
+         *
+         * @param str   string
+         * @return std::vector<long long>
+         */
+        std::vector<long long> equal(std::string_view str) const;
+    };
+
+    template<Type T>
+    void ListColumn<T>::flatten(K list) {
+        const signed char t = static_cast<signed char>(T);
+
+        // Size the buffer first so the copy pass never reallocates
+        long long total = 0;
+        for (long long i = 0; i < list->n; ++i) {
+            K row = kK(list)[i];
+            total += row->t == t ? row->n : (row->t == -t ? 1 : 0);
+        }
+        values_.resize(static_cast<size_t>(total));
+        offsets_.resize(static_cast<size_t>(list->n) + 1);
+        offsets_[0] = 0;
+
+        value_type *out = values_.data();
+        for (long long i = 0; i < list->n; ++i) {
+            K row = kK(list)[i];
+            if (row->t == t) {
+                std::memcpy(out, kG(row), static_cast<size_t>(row->n) * sizeof(value_type));
+                out += row->n;
+            } else if (row->t == -t) {
+                std::memcpy(out, &row->g, sizeof(value_type));
+                ++out;
+            } else {
+                ++mismatched_;
+            }
+            offsets_[i + 1] = out - values_.data();
+        }
+    }
+}
+
+#endif // __KDB_LIST_H__
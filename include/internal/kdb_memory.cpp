@@ -0,0 +1,55 @@
+/**
+ * @brief   Reference counting of kdb+ objects shared across threads
+ *
+ * @file    kdb_memory.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <thread>
+#include "kdb_memory.h"
+
+namespace kdb {
+    namespace internal {
+        std::atomic<bool> thread_safe_mode(false);
+
+        // Reference count changes are a handful of instructions, except the release of a
+        // large nested object, so a spin lock beats a mutex here.
+        static std::atomic_flag ref_lock = ATOMIC_FLAG_INIT;
+
+        class RefGuard {
+        public:
+            RefGuard() {
+                while (ref_lock.test_and_set(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            }
+            ~RefGuard() { ref_lock.clear(std::memory_order_release); }
+        };
+
+        K locked_r1(K x) {
+            RefGuard guard;
+            return r1(x);
+        }
+
+        void locked_r0(K x) {
+            // r0 also releases children of lists, dictionaries and tables, which may be
+            // referenced on their own by other threads, so the whole release is serialized.
+            RefGuard guard;
+            r0(x);
+        }
+    }
+
+    void set_thread_safe(bool on) {
+        setm(on ? 1 : 0);
+        internal::thread_safe_mode.store(on, std::memory_order_seq_cst);
+    }
+
+    bool thread_safe() {
+        return internal::thread_safe_mode.load(std::memory_order_relaxed);
+    }
+
+    void release_thread_memory() {
+        m9();
+    }
+}
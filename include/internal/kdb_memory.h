@@ -0,0 +1,74 @@
+/**
+ * @brief   Reference counting of kdb+ objects shared across threads
+ *
+ * @file    kdb_memory.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_MEMORY_H__
+#define __KDB_MEMORY_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <atomic>
+#include "../external/k.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Enable or disable thread-safe mode.
+     *
+     *          c.o increments and decrements reference counts without synchronization.
+     *          In thread-safe mode, every reference count change made by Result, Table and
+     *          Vector (including the recursive release of the last reference) is serialized,
+     *          and c.o symbol interning takes a lock (setm), so copies of the same Result
+     *          can be handed to worker threads without deep-copying the data.
+     *
+     *          Switch the mode before any object is shared between threads. Worker threads
+     *          must go through the wrappers and never call r0/r1 on shared objects directly.
+     *
+     * @param on    true to enable
+     */
+    void set_thread_safe(bool on);
+
+    /**
+     * @brief   Whether thread-safe mode is enabled
+     */
+    bool thread_safe();
+
+    /**
+     * @brief   Release the c.o memory pool of the calling thread. Call it from a worker
+     *          thread before it exits if it freed kdb+ objects.
+     */
+    void release_thread_memory();
+
+    namespace internal {
+        extern std::atomic<bool> thread_safe_mode;
+
+        K locked_r1(K x);
+        void locked_r0(K x);
+
+        /**
+         * @brief   Increment reference count, honoring thread-safe mode
+         */
+        inline K inc_ref(K x) {
+            return thread_safe_mode.load(std::memory_order_relaxed) ? locked_r1(x) : r1(x);
+        }
+
+        /**
+         * @brief   Decrement reference count (free if last), honoring thread-safe mode
+         */
+        inline void dec_ref(K x) {
+            if (thread_safe_mode.load(std::memory_order_relaxed)) {
+                locked_r0(x);
+            } else {
+                r0(x);
+            }
+        }
+    }
+}
+
+#endif // __KDB_MEMORY_H__
@@ -0,0 +1,74 @@
+/**
+ * @brief   Minimal fork-join helper for client-side column processing
+ *
+ * @file    kdb_parallel.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_PARALLEL_H__
+#define __KDB_PARALLEL_H__
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace kdb {
+    namespace internal {
+
+        /**
+         * @brief       Number of threads worth using for n items, at least grain items each
+         *
+         * @param max_threads   upper bound, 0 for the number of hardware threads
+         */
+        inline unsigned concurrency(long long n, long long grain, unsigned max_threads = 0) {
+            unsigned hw = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+            long long useful = grain > 0 ? (n + grain - 1) / grain : 1;
+            return static_cast<unsigned>(std::max(1LL, std::min<long long>(hw, useful)));
+        }
+
+        /**
+         * @brief       Run fn(begin, end) over [0, n) in chunks of grain items. Chunks are handed
+         *              out dynamically, so uneven chunks (e.g., key groups) balance out. Runs
+         *              inline when one thread is enough.
+         *
+         *              fn must not allocate or release kdb+ objects: c.o is not thread-safe.
+         *              Allocate outputs on the calling thread and fill them in fn.
+         *
+         * @param n     number of items
+         * @param grain items per chunk
+         * @param fn    callable(long long begin, long long end)
+         * @param max_threads   upper bound, 0 for the number of hardware threads
+         */
+        template<typename F>
+        void parallel_for(long long n, long long grain, F &&fn, unsigned max_threads = 0) {
+            if (n <= 0) {
+                return;
+            }
+            grain = std::max(1LL, grain);
+            unsigned n_threads = concurrency(n, grain, max_threads);
+            if (n_threads == 1) {
+                fn(0LL, n);
+                return;
+            }
+
+            std::atomic<long long> next(0);
+            auto work = [&]() {
+                for (long long begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain)) {
+                    fn(begin, std::min(n, begin + grain));
+                }
+            };
+            std::vector<std::thread> threads;
+            for (unsigned t = 1; t < n_threads; ++t) {
+                threads.emplace_back(work);
+            }
+            work();
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        }
+    }
+}
+
+#endif // __KDB_PARALLEL_H__
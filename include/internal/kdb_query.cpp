@@ -0,0 +1,424 @@
+/**
+ * @brief   Client-side filter, projection and group-by over kdb+ tables
+ *
+ * @file    kdb_query.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include "kdb_column.h"
+#include "kdb_index.h"
+#include "kdb_memory.h"
+#include "kdb_parallel.h"
+#include "kdb_query.h"
+
+namespace kdb {
+
+    namespace {
+        const long long kBatch = 1024;          // rows per predicate batch
+        const long long kChunk = 1 << 16;       // rows per parallel chunk
+
+        // Evaluate a predicate over [begin, end) into sel, or refine the n rows already in sel
+        template<typename V, typename C, typename Cmp>
+        long long apply(const V *x, C c, Cmp cmp, long long begin, long long end, long long *sel, long long n, bool first) {
+            long long m = 0;
+            if (first) {
+                for (long long i = begin; i < end; ++i) {
+                    sel[m] = i;
+                    m += cmp(static_cast<C>(x[i]), c);
+                }
+            } else {
+                for (long long j = 0; j < n; ++j) {
+                    long long i = sel[j];
+                    sel[m] = i;
+                    m += cmp(static_cast<C>(x[i]), c);
+                }
+            }
+            return m;
+        }
+
+        template<typename V, typename C>
+        long long apply_op(const V *x, Op op, C c, long long begin, long long end, long long *sel, long long n, bool first) {
+            switch (op) {
+            case Op::Eq: return apply(x, c, std::equal_to<C>(), begin, end, sel, n, first);
+            case Op::Ne: return apply(x, c, std::not_equal_to<C>(), begin, end, sel, n, first);
+            case Op::Lt: return apply(x, c, std::less<C>(), begin, end, sel, n, first);
+            case Op::Le: return apply(x, c, std::less_equal<C>(), begin, end, sel, n, first);
+            case Op::Gt: return apply(x, c, std::greater<C>(), begin, end, sel, n, first);
+            case Op::Ge: return apply(x, c, std::greater_equal<C>(), begin, end, sel, n, first);
+            }
+            return 0;
+        }
+
+        long long apply_symbol(const S *x, Op op, S c, long long begin, long long end, long long *sel, long long n, bool first) {
+            auto order = [](S a, S b) { return std::strcmp(a, b); };
+            switch (op) {
+            case Op::Eq: return apply(x, c, std::equal_to<S>(), begin, end, sel, n, first);    // pooled
+            case Op::Ne: return apply(x, c, std::not_equal_to<S>(), begin, end, sel, n, first);
+            case Op::Lt: return apply(x, c, [&](S a, S b) { return order(a, b) < 0; }, begin, end, sel, n, first);
+            case Op::Le: return apply(x, c, [&](S a, S b) { return order(a, b) <= 0; }, begin, end, sel, n, first);
+            case Op::Gt: return apply(x, c, [&](S a, S b) { return order(a, b) > 0; }, begin, end, sel, n, first);
+            case Op::Ge: return apply(x, c, [&](S a, S b) { return order(a, b) >= 0; }, begin, end, sel, n, first);
+            }
+            return 0;
+        }
+
+        template<typename V>
+        inline bool is_null(V v) {
+            if constexpr (std::is_floating_point<V>::value) {
+                return v != v;
+            } else if constexpr (std::is_same<V, H>::value) {
+                return v == static_cast<H>(nh);
+            } else if constexpr (std::is_same<V, I>::value) {
+                return v == ni;
+            } else if constexpr (std::is_same<V, J>::value) {
+                return v == nj;
+            } else {
+                return false;
+            }
+        }
+
+        // Per-thread partial aggregate of one column
+        template<typename V>
+        struct Partial {
+            std::vector<long long> sum_i;
+            std::vector<double> sum_f;
+            std::vector<long long> count;       // non-null values
+            std::vector<V> extreme;             // min or max
+        };
+
+        template<typename V>
+        Partial<V> accumulate(Agg agg, const V *x, const long long *rows, const uint32_t *groups,
+                              long long ngroups, long long begin, long long end) {
+            Partial<V> p;
+            p.count.assign(static_cast<size_t>(ngroups), 0);
+            if (agg == Agg::Sum || agg == Agg::Avg) {
+                if (std::is_floating_point<V>::value) {
+                    p.sum_f.assign(static_cast<size_t>(ngroups), 0.0);
+                } else {
+                    p.sum_i.assign(static_cast<size_t>(ngroups), 0);
+                }
+            } else {
+                p.extreme.assign(static_cast<size_t>(ngroups), V());
+            }
+
+            for (long long i = begin; i < end; ++i) {
+                V v = x[rows[i]];
+                if (is_null(v)) {
+                    continue;
+                }
+                uint32_t g = groups ? groups[i] : 0;
+                switch (agg) {
+                case Agg::Sum: case Agg::Avg:
+                    if constexpr (std::is_floating_point<V>::value) {
+                        p.sum_f[g] += v;
+                    } else {
+                        p.sum_i[g] += v;
+                    }
+                    break;
+                case Agg::Min:
+                    if (!p.count[g] || v < p.extreme[g]) p.extreme[g] = v;
+                    break;
+                case Agg::Max:
+                    if (!p.count[g] || v > p.extreme[g]) p.extreme[g] = v;
+                    break;
+                default:
+                    break;
+                }
+                ++p.count[g];
+            }
+            return p;
+        }
+
+        template<typename V>
+        K aggregate(Agg agg, K col, const long long *rows, long long n, const uint32_t *groups, long long ngroups) {
+            const V *x = reinterpret_cast<const V *>(kG(col));
+            long long grain = std::max(kChunk, (n + internal::concurrency(n, kChunk) - 1) / internal::concurrency(n, kChunk));
+            std::vector<Partial<V>> partials(static_cast<size_t>((n + grain - 1) / grain));
+            internal::parallel_for(n, grain, [&](long long begin, long long end) {
+                partials[begin / grain] = accumulate<V>(agg, x, rows, groups, ngroups, begin, end);
+            });
+
+            // Merge the partials into the first one
+            Partial<V> total = partials.empty() ? accumulate<V>(agg, x, rows, groups, ngroups, 0, 0) : std::move(partials[0]);
+            for (size_t p = 1; p < partials.size(); ++p) {
+                for (long long g = 0; g < ngroups; ++g) {
+                    const Partial<V> &part = partials[p];
+                    if (!part.count[g]) {
+                        continue;
+                    }
+                    if (!total.sum_i.empty()) total.sum_i[g] += part.sum_i[g];
+                    if (!total.sum_f.empty()) total.sum_f[g] += part.sum_f[g];
+                    if ((agg == Agg::Min && (!total.count[g] || part.extreme[g] < total.extreme[g])) ||
+                        (agg == Agg::Max && (!total.count[g] || part.extreme[g] > total.extreme[g]))) {
+                        total.extreme[g] = part.extreme[g];
+                    }
+                    total.count[g] += part.count[g];
+                }
+            }
+
+            K out;
+            switch (agg) {
+            case Agg::Sum:
+                if (std::is_floating_point<V>::value) {
+                    out = ktn(KF, ngroups);
+                    std::copy(total.sum_f.begin(), total.sum_f.end(), kF(out));
+                } else {
+                    out = ktn(KJ, ngroups);
+                    std::copy(total.sum_i.begin(), total.sum_i.end(), kJ(out));
+                }
+                break;
+            case Agg::Avg:
+                out = ktn(KF, ngroups);
+                for (long long g = 0; g < ngroups; ++g) {
+                    double sum = total.sum_f.empty() ? static_cast<double>(total.sum_i[g]) : total.sum_f[g];
+                    kF(out)[g] = total.count[g] ? sum / static_cast<double>(total.count[g]) : nf;
+                }
+                break;
+            default: // Min, Max
+                out = ktn(col->t, ngroups);
+                for (long long g = 0; g < ngroups; ++g) {
+                    if (total.count[g]) {
+                        reinterpret_cast<V *>(kG(out))[g] = total.extreme[g];
+                    } else {
+                        internal::fill_null(out, g, g + 1);
+                    }
+                }
+            }
+            return out;
+        }
+    }
+
+    Query::Query(const Table &tbl) : tbl_(tbl) {}
+
+    long long Query::column(const std::string &name) const {
+        long long col = tbl_.find_column(name.c_str());
+        if (col < 0) {
+            fprintf(stderr, "[kdb+] Column %s not found.\n", name.c_str());
+        }
+        return col;
+    }
+
+    Query::Predicate Query::make_predicate(const char *col, Op op) const {
+        return Predicate{column(col), op, false, 0, 0.0, nullptr};
+    }
+
+    Query &Query::add(Predicate pred) {
+        if (pred.col < 0) {
+            error_ = true;
+            return *this;
+        }
+        signed char t = internal::Access::column(tbl_, pred.col)->t;
+        if (t <= 0 || t == 2 || t >= 20 || (t == 11) != (pred.s != nullptr)) {
+            fprintf(stderr, "[kdb+] Unsupported predicate on column of type %d.\n", t);
+            error_ = true;
+            return *this;
+        }
+        preds_.push_back(pred);
+        return *this;
+    }
+
+    Query &Query::select(const std::vector<std::string> &cols) {
+        for (auto const &name : cols) {
+            long long col = column(name);
+            error_ |= col < 0;
+            select_.push_back(col);
+        }
+        return *this;
+    }
+
+    Query &Query::by(const std::vector<std::string> &cols) {
+        for (auto const &name : cols) {
+            long long col = column(name);
+            error_ |= col < 0;
+            by_.push_back(col);
+        }
+        return *this;
+    }
+
+    Query &Query::agg(Agg agg, const char *col, const char *name) {
+        long long c = column(col);
+        error_ |= c < 0;
+        aggs_.push_back(Aggregate{agg, c, ss(const_cast<S>(name ? name : col))});
+        return *this;
+    }
+
+    std::vector<long long> Query::filter() const {
+        long long n = tbl_.nrow();
+        std::vector<long long> rows;
+        if (error_) {
+            return rows;
+        }
+        if (preds_.empty()) {
+            rows.resize(static_cast<size_t>(n));
+            std::iota(rows.begin(), rows.end(), 0LL);
+            return rows;
+        }
+
+        std::vector<std::vector<long long>> chunks(static_cast<size_t>((n + kChunk - 1) / kChunk));
+        internal::parallel_for(static_cast<long long>(chunks.size()), 1, [&](long long begin, long long end) {
+            long long sel[kBatch];
+            for (long long chunk = begin; chunk < end; ++chunk) {
+                std::vector<long long> &out = chunks[chunk];
+                long long chunk_end = std::min(n, (chunk + 1) * kChunk);
+                for (long long b = chunk * kChunk; b < chunk_end; b += kBatch) {
+                    long long e = std::min(chunk_end, b + kBatch);
+                    long long m = 0;
+                    for (size_t p = 0; p < preds_.size() && (p == 0 || m > 0); ++p) {
+                        const Predicate &pred = preds_[p];
+                        K x = internal::Access::column(tbl_, pred.col);
+                        bool first = p == 0;
+                        switch (x->t) {
+                        case 1: case 4: case 10:
+                            m = pred.is_float ? apply_op(kG(x), pred.op, pred.f, b, e, sel, m, first)
+                                              : apply_op(kG(x), pred.op, pred.i, b, e, sel, m, first);
+                            break;
+                        case 5:
+                            m = pred.is_float ? apply_op(kH(x), pred.op, pred.f, b, e, sel, m, first)
+                                              : apply_op(kH(x), pred.op, pred.i, b, e, sel, m, first);
+                            break;
+                        case 6: case 13: case 14: case 17: case 18: case 19:
+                            m = pred.is_float ? apply_op(kI(x), pred.op, pred.f, b, e, sel, m, first)
+                                              : apply_op(kI(x), pred.op, pred.i, b, e, sel, m, first);
+                            break;
+                        case 7: case 12: case 16:
+                            m = pred.is_float ? apply_op(kJ(x), pred.op, pred.f, b, e, sel, m, first)
+                                              : apply_op(kJ(x), pred.op, pred.i, b, e, sel, m, first);
+                            break;
+                        case 8:
+                            m = apply_op(kE(x), pred.op, pred.f, b, e, sel, m, first);
+                            break;
+                        case 9: case 15:
+                            m = apply_op(kF(x), pred.op, pred.f, b, e, sel, m, first);
+                            break;
+                        case 11:
+                            m = apply_symbol(kS(x), pred.op, pred.s, b, e, sel, m, first);
+                            break;
+                        }
+                    }
+                    out.insert(out.end(), sel, sel + m);
+                }
+            }
+        });
+
+        for (auto const &chunk : chunks) {
+            rows.insert(rows.end(), chunk.begin(), chunk.end());
+        }
+        return rows;
+    }
+
+    Result Query::run() const {
+        if (error_) {
+            return Result(nullptr);
+        }
+        K header = kK(internal::Access::k(tbl_)->k)[0];
+        std::vector<long long> rows = filter();
+        long long n = static_cast<long long>(rows.size());
+
+        // Projection: share the columns if nothing is filtered out
+        if (aggs_.empty()) {
+            std::vector<long long> cols = select_;
+            if (cols.empty()) {
+                cols.resize(static_cast<size_t>(tbl_.ncol()));
+                std::iota(cols.begin(), cols.end(), 0LL);
+            }
+            std::vector<S> names;
+            std::vector<K> columns;
+            for (auto const &c : cols) {
+                K col = internal::Access::column(tbl_, c);
+                names.push_back(kS(header)[c]);
+                columns.push_back(preds_.empty() ? internal::inc_ref(col) : internal::gather(col, rows.data(), n));
+            }
+            return Result(internal::make_table(names, columns), false);
+        }
+
+        // Group
+        std::vector<long long> first_rows, last_rows;
+        const uint32_t *groups = nullptr;
+        std::unique_ptr<KeyIndex> index;
+        if (by_.empty()) {
+            first_rows.push_back(n ? rows.front() : -1);
+            last_rows.push_back(n ? rows.back() : -1);
+        } else {
+            index.reset(new KeyIndex(tbl_, by_, rows.data(), n));
+            if (!index->valid()) {
+                return Result(nullptr);
+            }
+            groups = index->groups().data();
+            for (long long g = 0; g < index->ngroups(); ++g) {
+                first_rows.push_back(index->first_row(g));
+            }
+            last_rows.resize(first_rows.size());
+            for (long long i = 0; i < n; ++i) {
+                last_rows[groups[i]] = rows[i];
+            }
+        }
+        long long ngroups = static_cast<long long>(first_rows.size());
+
+        // Aggregate
+        std::vector<S> names;
+        std::vector<K> columns;
+        for (auto const &agg : aggs_) {
+            K col = internal::Access::column(tbl_, agg.col);
+            K out = nullptr;
+            switch (agg.agg) {
+            case Agg::Count:
+                out = ktn(KJ, ngroups);
+                std::fill(kJ(out), kJ(out) + ngroups, 0LL);
+                for (long long i = 0; i < n; ++i) {
+                    ++kJ(out)[groups ? groups[i] : 0];
+                }
+                break;
+            case Agg::First:
+                out = internal::gather(col, first_rows.data(), ngroups);
+                break;
+            case Agg::Last:
+                out = internal::gather(col, last_rows.data(), ngroups);
+                break;
+            default:
+                switch (col->t) {
+                case 1: case 4:
+                    out = aggregate<G>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                case 5:
+                    out = aggregate<H>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                case 6: case 13: case 14: case 17: case 18: case 19:
+                    out = aggregate<I>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                case 7: case 12: case 16:
+                    out = aggregate<J>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                case 8:
+                    out = aggregate<E>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                case 9: case 15:
+                    out = aggregate<F>(agg.agg, col, rows.data(), n, groups, ngroups); break;
+                }
+            }
+            if (!out) {
+                fprintf(stderr, "[kdb+] Unsupported aggregation on column of type %d.\n", col->t);
+                for (auto const &c : columns) {
+                    internal::dec_ref(c);
+                }
+                return Result(nullptr);
+            }
+            names.push_back(agg.name);
+            columns.push_back(out);
+        }
+        K values = internal::make_table(names, columns);
+        if (by_.empty()) {
+            return Result(values, false);
+        }
+
+        // Keyed by the group keys, like q select ... by
+        std::vector<S> key_names;
+        std::vector<K> keys;
+        for (auto const &c : by_) {
+            key_names.push_back(kS(header)[c]);
+            keys.push_back(internal::gather(internal::Access::column(tbl_, c), first_rows.data(), ngroups));
+        }
+        return Result(xD(internal::make_table(key_names, keys), values), false);
+    }
+}
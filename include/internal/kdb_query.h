@@ -0,0 +1,144 @@
+/**
+ * @brief   Client-side filter, projection and group-by over kdb+ tables
+ *
+ * @file    kdb_query.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_QUERY_H__
+#define __KDB_QUERY_H__
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "kdb_result.h"
+#include "kdb_table.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Comparison of a column against a constant
+     */
+    enum class Op {
+        Eq, Ne, Lt, Le, Gt, Ge
+    };
+
+    /**
+     * @brief   Aggregations, nulls are skipped like q except by count, first and last
+     */
+    enum class Agg {
+        Sum, Avg, Min, Max, Count, First, Last
+    };
+
+    /**
+     * @brief   Vectorized select over a Table, i.e., select aggs by keys from tbl where preds.
+     *          Source columns are read in place and never copied.
+     *
+     *          Predicates are evaluated in batches into a selection vector of row indexes,
+     *          refining it one predicate at a time; large tables are split across threads.
+     *          Group-by hashes the keys, or follows runs of equal keys when grouping by a
+     *          single sorted or parted column.
+     */
+    class Query {
+    public:
+        Query(const Table &tbl);
+
+        /**
+         * @brief       Add a predicate: col op value. Predicates are and-ed.
+         *
+         * @tparam T    integral, floating point, or const char* / std::string for symbol columns
+         * @param col   column name
+         * @param op    comparison
+         * @param value constant; symbols compare lexicographically except for Eq and Ne
+         * @return Query&
+         */
+        template<typename T>
+        Query &where(const char *col, Op op, const T &value);
+
+        /**
+         * @brief       Project columns, default is all columns. Ignored if aggregating.
+         *
+         * @param cols  column names
+         * @return Query&
+         */
+        Query &select(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Group by columns
+         *
+         * @param cols  column names
+         * @return Query&
+         */
+        Query &by(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Add an aggregation. Sum is long for integral columns, Avg is float,
+         *              Count is long, others keep the column type.
+         *
+         * @param agg   aggregation
+         * @param col   column name
+         * @param name  output column name, default is col
+         * @return Query&
+         */
+        Query &agg(Agg agg, const char *col, const char *name = nullptr);
+
+        /**
+         * @brief   Rows satisfying all predicates, in ascending order
+         *
+         * @return std::vector<long long>
+         */
+        std::vector<long long> filter() const;
+
+        /**
+         * @brief   Run the query
+         *
+         * @return Result   table, keyed table if grouped, or Result(nullptr) on error
+         */
+        Result run() const;
+
+    private:
+        struct Predicate {
+            long long col;
+            Op op;
+            bool is_float;          // compare as double
+            long long i;
+            double f;
+            S s;
+        };
+
+        struct Aggregate {
+            Agg agg;
+            long long col;
+            S name;
+        };
+
+        Predicate make_predicate(const char *col, Op op) const;
+        Query &add(Predicate pred);
+        long long column(const std::string &name) const;
+
+        Table tbl_;
+        std::vector<Predicate> preds_;
+        std::vector<long long> select_;
+        std::vector<long long> by_;
+        std::vector<Aggregate> aggs_;
+        bool error_ = false;
+    };
+
+    template<typename T>
+    Query &Query::where(const char *col, Op op, const T &value) {
+        Predicate pred = make_predicate(col, op);
+        if constexpr (std::is_integral<T>::value) {
+            pred.i = static_cast<long long>(value);
+            pred.f = static_cast<double>(value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            pred.is_float = true;
+            pred.f = static_cast<double>(value);
+        } else {
+            pred.s = ss(const_cast<S>(std::string(value).c_str()));
+        }
+        return add(pred);
+    }
+}
+
+#endif // __KDB_QUERY_H__
@@ -0,0 +1,114 @@
+/**
+ * @brief   Registry of q lambdas installed on the server once and called by name
+ *
+ * @file    kdb_registry.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include "kdb_column.h"
+#include "kdb_registry.h"
+
+namespace kdb {
+
+    namespace {
+
+        // FNV-1a: names a lambda by its source
+        uint64_t hash_source(const std::string &source) {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (unsigned char c : source) {
+                h = (h ^ c) * 0x100000001b3ULL;
+            }
+            return h;
+        }
+    }
+
+    FunctionRegistry::FunctionRegistry(Connector &kcon, const char *ns) : kcon_(kcon), ns_(ns) {}
+
+    void FunctionRegistry::define(const char *name, const char *source) {
+        Function &fn = functions_[name];
+        fn.source = source;
+        fn.hash = hash_source(fn.source);
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(fn.hash));
+        fn.server_name = ns_ + ".f" + hex;
+        fn.stats = {0, 0, 0, 0};
+    }
+
+    bool FunctionRegistry::install(Function &fn) {
+        if (kcon_.connection_id() != connection_id_) {
+            installed_.clear();     // a new connection has none of them
+            connection_id_ = kcon_.connection_id();
+        }
+        if (installed_.count(fn.hash)) {
+            return true;
+        }
+        Result res = kcon_.sync("{x set value y}", {Result(ks(const_cast<S>(fn.server_name.c_str())), false),
+                                                   Result(kp(const_cast<S>(fn.source.c_str())), false)});
+        if (nullptr == internal::Access::k(res)) {
+            fprintf(stderr, "[kdb+] Failed to install %s.\n", fn.server_name.c_str());
+            return false;
+        }
+        installed_.insert(fn.hash);
+        ++fn.stats.installs;
+        return true;
+    }
+
+    bool FunctionRegistry::install() {
+        bool ok = true;
+        for (auto &it : functions_) {
+            ok = install(it.second) && ok;
+        }
+        return ok;
+    }
+
+    Result FunctionRegistry::call(const char *name, const std::vector<Result> &args) {
+        auto it = functions_.find(name);
+        if (it == functions_.end()) {
+            fprintf(stderr, "[kdb+] No function %s in the registry.\n", name);
+            return Result(nullptr);
+        }
+        Function &fn = it->second;
+        unsigned long long installs = fn.stats.installs;
+        if (!install(fn)) {
+            return Result(nullptr);
+        }
+        ++fn.stats.calls;
+        if (fn.stats.installs == installs) {
+            ++fn.stats.parses_saved;
+            if (fn.source.size() > fn.server_name.size()) {
+                fn.stats.bytes_saved += fn.source.size() - fn.server_name.size();
+            }
+        }
+        unsigned long long id = kcon_.connection_id();
+        Result res = kcon_.call(fn.server_name.c_str(), args);
+        if (nullptr == internal::Access::k(res) && kcon_.connection_id() != id && kcon_.reconnect_policy().replay_sync) {
+            // Reconnected during the call, which was replayed before the lambda was installed
+            if (install(fn)) {
+                res = kcon_.call(fn.server_name.c_str(), args);
+            }
+        }
+        return res;
+    }
+
+    std::string FunctionRegistry::server_name(const char *name) const {
+        auto it = functions_.find(name);
+        return it == functions_.end() ? std::string() : it->second.server_name;
+    }
+
+    FunctionRegistry::Stats FunctionRegistry::stats(const char *name) const {
+        if (name != nullptr) {
+            auto it = functions_.find(name);
+            return it == functions_.end() ? Stats{0, 0, 0, 0} : it->second.stats;
+        }
+        Stats total = {0, 0, 0, 0};
+        for (auto const &it : functions_) {
+            total.calls += it.second.stats.calls;
+            total.installs += it.second.stats.installs;
+            total.parses_saved += it.second.stats.parses_saved;
+            total.bytes_saved += it.second.stats.bytes_saved;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @brief   Registry of q lambdas installed on the server once and called by name
+ *
+ * @file    kdb_registry.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_REGISTRY_H__
+#define __KDB_REGISTRY_H__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "kdb_connector.h"
+#include "kdb_result.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Named q lambdas, defined on the server the first time they are called on a
+     *          connection and then called by name with the arguments in binary. The lambda is
+     *          sent and parsed once per connection instead of on every call.
+     *
+     *          FunctionRegistry fns(kcon);
+     *          fns.define("bars", "{[s;w] select o:first px, c:last px by w xbar time from trade where sym=s}");
+     *          Result r = fns.call("bars", {Result(ks((S)"IBM"), false), Result(ktj(-KN, 60000000000LL), false)});
+     *
+     *          On the server a lambda is named after a hash of its source, e.g., .kdbcpp.f1b2c...,
+     *          so redefining it installs a new function and never calls a stale one. Lambdas are
+     *          installed again after a reconnect. Like the Connector, a FunctionRegistry is used
+     *          from one thread at a time.
+     */
+    class FunctionRegistry {
+    public:
+        struct Stats {
+            unsigned long long calls;
+            unsigned long long installs;        // lambdas sent to the server
+            unsigned long long parses_saved;    // calls that did not send the lambda
+            unsigned long long bytes_saved;     // source bytes not sent, less the names sent instead
+        };
+
+        /**
+         * @param kcon  connection, must outlive the registry
+         * @param ns    q namespace of the installed functions
+         */
+        explicit FunctionRegistry(Connector &kcon, const char *ns = ".kdbcpp");
+
+        FunctionRegistry(const FunctionRegistry &) = delete;
+        FunctionRegistry &operator=(const FunctionRegistry &) = delete;
+
+        /**
+         * @brief       Define or redefine a lambda. Nothing is sent until it is called.
+         *
+         * @param name  local name
+         * @param source    q lambda, e.g., "{x+y}", at most 8 parameters
+         */
+        void define(const char *name, const char *source);
+
+        /**
+         * @brief       Call a lambda, installing it first if it is not on this connection yet
+         *
+         * @return Result   result, or Result(nullptr) if unknown, failed to install or failed
+         */
+        Result call(const char *name, const std::vector<Result> &args);
+
+        /**
+         * @brief       Install every defined lambda not yet on this connection, e.g., right after
+         *              connect() to keep the first calls fast
+         *
+         * @return false    an install failed
+         */
+        bool install();
+
+        /**
+         * @brief       Name of a lambda on the server, e.g., to call it from other q code
+         *
+         * @return std::string  empty if not defined
+         */
+        std::string server_name(const char *name) const;
+
+        /**
+         * @brief       Statistics of one lambda, or of all if name is nullptr
+         */
+        Stats stats(const char *name = nullptr) const;
+
+    private:
+        struct Function {
+            std::string source;
+            std::string server_name;
+            uint64_t hash;
+            Stats stats;
+        };
+
+        bool install(Function &fn);
+
+        Connector &kcon_;
+        std::string ns_;
+        std::unordered_map<std::string, Function> functions_;
+        std::unordered_set<uint64_t> installed_;        // hashes of lambdas on the connection
+        unsigned long long connection_id_ = 0;          // connection they were installed on
+    };
+}
+
+#endif // __KDB_REGISTRY_H__
@@ -0,0 +1,401 @@
+/**
+ * @brief   Fan-out of raw kdb+ IPC messages from one upstream to many downstream clients
+ *
+ * @file    kdb_relay.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "kdb_ipc.h"
+#include "kdb_relay.h"
+
+namespace kdb {
+
+    namespace {
+
+        // Null-terminated string at p, advancing p past it
+        bool read_string(const G *&p, const G *end, std::string_view &s) {
+            const void *nul = std::memchr(p, 0, static_cast<size_t>(end - p));
+            if (nullptr == nul) {
+                return false;
+            }
+            s = std::string_view(reinterpret_cast<const char *>(p), static_cast<const G *>(nul) - p);
+            p = static_cast<const G *>(nul) + 1;
+            return true;
+        }
+
+        // Vector header at p: type, attribute and length
+        bool read_vector(const G *&p, const G *end, signed char t, int &n) {
+            if (end - p < 6 || static_cast<signed char>(*p) != t) {
+                return false;
+            }
+            std::memcpy(&n, p + 2, sizeof(n));
+            p += 6;
+            return n >= 0;
+        }
+
+        /**
+         * @brief   An update, (`upd; `table; data), peeked at in place
+         */
+        struct Update {
+            std::string_view table;
+            bool has_syms = false;
+            std::unordered_set<std::string_view> syms;
+
+            // false if the message is not an update
+            bool parse(const G *p, const G *end, bool want_syms) {
+                int n;
+                if (!read_vector(p, end, 0, n) || n < 3) {
+                    return false;
+                }
+                std::string_view fn;
+                if (end - p < 1 || -KS != static_cast<signed char>(*p++) || !read_string(p, end, fn)
+                    || end - p < 1 || -KS != static_cast<signed char>(*p++) || !read_string(p, end, table)) {
+                    return false;
+                }
+                if (want_syms) {
+                    has_syms = sym_column(p, end);
+                }
+                return true;
+            }
+
+            // Collect the distinct syms of a table, or of a list of columns (time; sym; ...)
+            bool sym_column(const G *p, const G *end) {
+                long long index = 1;
+                if (end - p >= 2 && XT == static_cast<signed char>(p[0])) {
+                    p += 2;
+                    if (end - p < 1 || XD != static_cast<signed char>(*p++)) {
+                        return false;
+                    }
+                    int n_cols;
+                    if (!read_vector(p, end, KS, n_cols)) {
+                        return false;
+                    }
+                    index = -1;
+                    for (int i = 0; i < n_cols; ++i) {
+                        std::string_view name;
+                        if (!read_string(p, end, name)) {
+                            return false;
+                        }
+                        if (name == "sym" && index < 0) {
+                            index = i;
+                        }
+                    }
+                    if (index < 0) {
+                        return false;
+                    }
+                }
+
+                int n_cols;
+                if (!read_vector(p, end, 0, n_cols) || index >= n_cols) {
+                    return false;
+                }
+                for (long long i = 0; i < index && p != nullptr; ++i) {
+                    p = internal::skip(p, end);
+                }
+                int n_rows;
+                if (nullptr == p || !read_vector(p, end, KS, n_rows)) {
+                    return false;
+                }
+                for (int i = 0; i < n_rows; ++i) {
+                    std::string_view sym;
+                    if (!read_string(p, end, sym)) {
+                        return false;
+                    }
+                    syms.insert(sym);
+                }
+                return true;
+            }
+        };
+
+        std::unordered_set<std::string_view> to_set(const std::vector<std::string> &v) {
+            return std::unordered_set<std::string_view>(v.begin(), v.end());
+        }
+    }
+
+    Relay::Relay(Connector &upstream, size_t queue_capacity, SlowConsumer policy)
+        : upstream_(upstream), capacity_(queue_capacity > 0 ? queue_capacity : 1), policy_(policy) {}
+
+    Relay::~Relay() {
+        for (auto &client : clients_) {
+            {
+                std::lock_guard<std::mutex> lock(client->mutex);
+                client->closing = true;
+            }
+            shutdown(client->fd, SHUT_RDWR);    // unblock a pending write
+            client->ready.notify_all();
+            client->room.notify_all();
+            client->writer.join();
+            close(client->fd);
+        }
+        for (auto &listener : listeners_) {
+            close(listener.fd);
+        }
+    }
+
+    bool Relay::listen(int port, const Filter &filter) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            fprintf(stderr, "[kdb+] Failed to create relay socket.\n");
+            return false;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(fd, 64) < 0) {
+            fprintf(stderr, "[kdb+] Failed to listen on port %d.\n", port);
+            close(fd);
+            return false;
+        }
+        listeners_.push_back(Listener{fd, filter});
+        fprintf(stdout, "[kdb+] Relay listening on port %d.\n", port);
+        return true;
+    }
+
+    void Relay::accept_client(const Listener &listener) {
+        int fd = accept(listener.fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+
+        // kdb+ handshake: "user:password" and a capability byte, null-terminated
+        timeval tv = {1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        char credentials[1024];
+        size_t n = 0;
+        while (n < sizeof(credentials) && internal::read_all(fd, credentials + n, 1) && credentials[n] != '\0') {
+            ++n;
+        }
+        if (n == sizeof(credentials) || n == 0 || credentials[n] != '\0') {
+            fprintf(stderr, "[kdb+] Relay handshake failed.\n");
+            close(fd);
+            return;
+        }
+        unsigned char capability = static_cast<unsigned char>(credentials[n - 1]) < 32
+            ? std::min<unsigned char>(static_cast<unsigned char>(credentials[n - 1]), 3) : 0;
+        if (!internal::write_all(fd, &capability, 1)) {
+            close(fd);
+            return;
+        }
+        tv = {0, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        add_client(fd, listener.filter);
+    }
+
+    void Relay::add_client(int fd, const Filter &filter) {
+        std::unique_ptr<Client> client(new Client());
+        client->fd = fd;
+        client->filter = filter;
+        client->tables = to_set(client->filter.tables);
+        client->syms = to_set(client->filter.syms);
+        Client &ref = *client;
+        client->writer = std::thread([this, &ref]() { write_loop(ref); });
+
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients_.push_back(std::move(client));
+    }
+
+    bool Relay::poll(int timeout) {
+        // Read through the upstream Connector: any transport works, and a lost connection is
+        // dropped and reconnected by its policy. Nothing is replayed: renewing the
+        // subscription on a new connection is for the caller.
+        bool failed = false;
+        bool ok = upstream_.request([&]() {
+            // Shared memory has no descriptor: accept pending clients, then wait on the ring
+            int upstream_fd = upstream_.shm_ != nullptr ? -1 : upstream_.hdl_;
+            std::vector<pollfd> fds(1 + listeners_.size());
+            fds[0] = pollfd{upstream_fd, POLLIN, 0};    // ignored by poll if negative
+            for (size_t i = 0; i < listeners_.size(); ++i) {
+                fds[i + 1] = pollfd{listeners_[i].fd, POLLIN, 0};
+            }
+            if (::poll(fds.data(), fds.size(), upstream_fd < 0 ? 0 : timeout) < 0) {
+                failed = errno != EINTR;
+                return true;
+            }
+            reap();
+            for (size_t i = 0; i < listeners_.size(); ++i) {
+                if (fds[i + 1].revents & POLLIN) {
+                    accept_client(listeners_[i]);
+                }
+            }
+            if (upstream_fd < 0 ? !upstream_.shm_->readable(timeout) : 0 == fds[0].revents) {
+                return true;
+            }
+
+            internal::Header header;
+            if (!upstream_.read_raw(&header, sizeof(header)) || header.size < sizeof(header)) {
+                upstream_.drop();
+                return false;
+            }
+            std::shared_ptr<std::vector<unsigned char>> frame = std::make_shared<std::vector<unsigned char>>(header.size);
+            std::memcpy(frame->data(), &header, sizeof(header));
+            if (!upstream_.read_raw(frame->data() + sizeof(header), header.size - sizeof(header))) {
+                upstream_.drop();   // cut mid-message
+                return false;
+            }
+            ++received_;
+            dispatch(frame);
+            return true;
+        }, false);
+        return ok && !failed;
+    }
+
+    void Relay::dispatch(const Frame &frame) {
+        // Only reap() on this thread removes clients, so they outlive the copy. The lock is not
+        // held while a full queue blocks, so add_client() and clients() do not wait on it.
+        std::vector<Client *> clients;
+        {
+            std::lock_guard<std::mutex> lock(clients_mutex_);
+            for (auto &client : clients_) {
+                clients.push_back(client.get());
+            }
+        }
+        bool want_table = false;
+        bool want_syms = false;
+        for (Client *client : clients) {
+            want_table = want_table || !client->tables.empty();
+            want_syms = want_syms || !client->syms.empty();
+        }
+
+        Update update;
+        bool is_update = false;
+        K raw = nullptr;
+        if (want_table || want_syms) {
+            const G *begin = frame->data();
+            size_t size = frame->size();
+            if (begin[2]) {
+                // Peek at the decompressed copy, forward the compressed frame
+                raw = internal::decompress(begin, size);
+                begin = raw != nullptr ? kG(raw) : nullptr;
+                size = raw != nullptr ? static_cast<size_t>(raw->n) : 0;
+            }
+            is_update = begin != nullptr && 1 == begin[0]
+                && update.parse(begin + sizeof(internal::Header), begin + size, want_syms);
+        }
+
+        for (Client *client : clients) {
+            bool pass = !is_update
+                || ((client->tables.empty() || client->tables.count(update.table))
+                    && (client->syms.empty() || !update.has_syms
+                        || std::any_of(update.syms.begin(), update.syms.end(),
+                                       [&](std::string_view s) { return client->syms.count(s) > 0; })));
+            if (pass) {
+                enqueue(*client, frame);
+            } else {
+                ++filtered_;
+            }
+        }
+        if (raw != nullptr) {
+            r0(raw);
+        }
+    }
+
+    void Relay::enqueue(Client &client, const Frame &frame) {
+        std::unique_lock<std::mutex> lock(client.mutex);
+        if (client.closing) {
+            return;
+        }
+        if (client.queue.size() >= capacity_) {
+            switch (policy_) {
+            case SlowConsumer::Block:
+                client.room.wait(lock, [&]() { return client.closing || client.queue.size() < capacity_; });
+                if (client.closing) {
+                    return;
+                }
+                break;
+            case SlowConsumer::DropOldest:
+                client.queue.pop_front();
+                ++dropped_;
+                break;
+            case SlowConsumer::DropNewest:
+                ++dropped_;
+                return;
+            case SlowConsumer::Disconnect:
+                ++dropped_;
+                client.closing = true;
+                client.dead = true;
+                shutdown(client.fd, SHUT_RDWR);     // unblock a pending write
+                client.ready.notify_all();
+                return;
+            }
+        }
+        client.queue.push_back(frame);
+        ++forwarded_;
+        client.ready.notify_one();
+    }
+
+    void Relay::write_loop(Client &client) {
+        for (;;) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(client.mutex);
+                client.ready.wait(lock, [&]() { return client.closing || !client.queue.empty(); });
+                if (client.closing) {
+                    return;
+                }
+                frame = std::move(client.queue.front());
+                client.queue.pop_front();
+            }
+            client.room.notify_one();
+
+            if (!internal::write_all(client.fd, frame->data(), frame->size())) {
+                std::lock_guard<std::mutex> lock(client.mutex);
+                client.closing = true;
+                client.dead = true;
+                client.queue.clear();
+                client.room.notify_all();
+                return;
+            }
+        }
+    }
+
+    void Relay::reap() {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        for (auto it = clients_.begin(); it != clients_.end();) {
+            Client &client = **it;
+            if (client.dead) {
+                client.writer.join();
+                close(client.fd);
+                ++disconnected_;
+                it = clients_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void Relay::run() {
+        running_ = true;
+        while (running_ && poll(100)) {
+        }
+        running_ = false;
+    }
+
+    void Relay::stop() {
+        running_ = false;
+    }
+
+    size_t Relay::clients() const {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        return clients_.size();
+    }
+
+    Relay::Stats Relay::stats() const {
+        return Stats{received_, forwarded_, filtered_, dropped_, disconnected_};
+    }
+}
@@ -0,0 +1,171 @@
+/**
+ * @brief   Fan-out of raw kdb+ IPC messages from one upstream to many downstream clients
+ *
+ * @file    kdb_relay.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_RELAY_H__
+#define __KDB_RELAY_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "kdb_connector.h"
+
+namespace kdb {
+
+    /**
+     * @brief   What a relay does with a message for a client whose queue is full
+     */
+    enum class SlowConsumer {
+        Block,          // wait for room, stalling every client
+        DropOldest,     // discard the oldest queued message
+        DropNewest,     // discard the new message
+        Disconnect      // close the client
+    };
+
+    /**
+     * @brief   Messages a downstream client receives. Updates, i.e., (`upd; `table; data),
+     *          pass if the table is listed and any row has a listed sym; empty lists pass
+     *          everything. Other messages, e.g., (`.u.end; date), always pass.
+     *
+     *          A passing message is forwarded whole: rows of other syms are not removed.
+     */
+    struct Filter {
+        std::vector<std::string> tables;
+        std::vector<std::string> syms;
+    };
+
+    /**
+     * @brief   Relays the messages received on an upstream connection, e.g., a tickerplant
+     *          subscription, to downstream kdb+ clients without decoding them.
+     *
+     *          Each message is read once into a reference counted buffer, filtered by peeking
+     *          at its table name and sym column in place, and the same buffer is queued for
+     *          every matching client. One writer thread per client drains its bounded queue,
+     *          so a slow client only affects others under SlowConsumer::Block.
+     *
+     *          Subscribe upstream before relaying, e.g., kcon.sync(".u.sub[`;`]").
+     */
+    class Relay {
+    public:
+        struct Stats {
+            unsigned long long received;        // messages read from upstream
+            unsigned long long forwarded;       // messages queued, counted once per client
+            unsigned long long filtered;        // messages withheld by filters, counted once per client
+            unsigned long long dropped;         // messages discarded because a queue was full
+            unsigned long long disconnected;    // clients closed, by error or by policy
+        };
+
+        /**
+         * @param upstream  connection to read messages from, must outlive the relay
+         * @param queue_capacity    messages queued per client at most
+         * @param policy    what to do when a client queue is full
+         */
+        Relay(Connector &upstream, size_t queue_capacity=1024, SlowConsumer policy=SlowConsumer::DropOldest);
+        ~Relay();
+
+        Relay(const Relay &) = delete;
+        Relay &operator=(const Relay &) = delete;
+
+        /**
+         * @brief Accept kdb+ clients on a TCP port, e.g., hopen `:relayhost:port from q
+         *
+         * @param port      port to listen on
+         * @param filter    filter of the clients accepted on this port
+         * @return true     listening
+         * @return false    failed to bind or listen
+         */
+        bool listen(int port, const Filter &filter=Filter());
+
+        /**
+         * @brief Add a client on a socket that already completed the kdb+ handshake
+         *
+         * @param fd        socket, closed by the relay
+         * @param filter    filter of the client
+         */
+        void add_client(int fd, const Filter &filter=Filter());
+
+        /**
+         * @brief Wait for one upstream message and relay it, accepting new clients meanwhile.
+         *        A lost upstream connection is reconnected by the policy of the Connector;
+         *        subscribe again when its connection_id() changes. On shared memory, new
+         *        clients are accepted before the wait rather than during it.
+         *
+         * @param timeout   in milliseconds, -1 to wait indefinitely
+         * @return true     relayed a message or timed out
+         * @return false    upstream connection lost, reconnected or not
+         */
+        bool poll(int timeout=1000);
+
+        /**
+         * @brief Relay until stop() is called or the upstream connection is lost
+         */
+        void run();
+
+        /**
+         * @brief Make run() return, can be called from any thread
+         */
+        void stop();
+
+        /**
+         * @brief Number of connected clients
+         */
+        size_t clients() const;
+
+        Stats stats() const;
+
+    private:
+        typedef std::shared_ptr<const std::vector<unsigned char>> Frame;
+
+        struct Client {
+            int fd;
+            Filter filter;
+            std::unordered_set<std::string_view> tables;    // views of filter
+            std::unordered_set<std::string_view> syms;
+            std::deque<Frame> queue;
+            std::mutex mutex;
+            std::condition_variable ready;      // message queued or closing
+            std::condition_variable room;       // message dequeued or closing
+            bool closing = false;
+            std::atomic<bool> dead{false};
+            std::thread writer;
+        };
+
+        struct Listener {
+            int fd;
+            Filter filter;
+        };
+
+        void accept_client(const Listener &listener);
+        void dispatch(const Frame &frame);
+        void enqueue(Client &client, const Frame &frame);
+        void write_loop(Client &client);
+        void reap();
+
+        Connector &upstream_;
+        size_t capacity_;
+        SlowConsumer policy_;
+        std::vector<Listener> listeners_;
+        std::vector<std::unique_ptr<Client>> clients_;
+        mutable std::mutex clients_mutex_;
+        std::atomic<bool> running_{false};
+        std::atomic<unsigned long long> received_{0};
+        std::atomic<unsigned long long> forwarded_{0};
+        std::atomic<unsigned long long> filtered_{0};
+        std::atomic<unsigned long long> dropped_{0};
+        std::atomic<unsigned long long> disconnected_{0};
+    };
+}
+
+#endif // __KDB_RELAY_H__
@@ -0,0 +1,270 @@
+/**
+ * @brief   Lazy handle on a table of a kdb+ server, fetching columns on demand
+ *
+ * @file    kdb_remote.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include "kdb_column.h"
+#include "kdb_memory.h"
+#include "kdb_remote.h"
+
+namespace kdb {
+
+    // Schema of a table by name: (column names; meta types; row count)
+    static const char *kSchemaQuery = "{(cols x;exec t from meta x;count value x)}";
+    // Columns z of table x, rows (start; count) y
+    static const char *kFetchQuery = "{y sublist ?[x;();0b;z!z]}";
+
+    // Approximate memory of a column, one level deep for nested columns
+    static size_t bytes(K x) {
+        if (x->t < 0) {
+            return 8;
+        } else if (0 == x->t) {
+            size_t n = 8 * static_cast<size_t>(x->n);
+            for (long long i = 0; i < x->n; ++i) {
+                n += bytes(kK(x)[i]);
+            }
+            return n;
+        }
+        return static_cast<size_t>(internal::type_size(x->t)) * static_cast<size_t>(x->n);
+    }
+
+    RemoteTable::RemoteTable(Connector &kcon, const char *name) : kcon_(kcon), name_(name) {
+        Result schema = kcon_.sync(kSchemaQuery, {Result(ks(const_cast<S>(name)), false)});
+        ++stats_.round_trips;
+        K x = internal::Access::k(schema);
+        if (nullptr == x || x->t != 0 || x->n != 3 || kK(x)[0]->t != 11 || kK(x)[1]->t != 10
+            || kK(x)[1]->n != kK(x)[0]->n || kK(x)[2]->t != -7) {
+            fprintf(stderr, "[kdb+] Failed to fetch the schema of %s.\n", name);
+            return;
+        }
+
+        K names = kK(x)[0];
+        for (long long i = 0; i < names->n; ++i) {
+            columns_.push_back(kS(names)[i]);
+        }
+        types_.assign(reinterpret_cast<const char *>(kC(kK(x)[1])), static_cast<size_t>(names->n));
+        cache_.resize(columns_.size());
+        hinted_.assign(columns_.size(), false);
+        nrow_ = kK(x)[2]->j;
+    }
+
+    RemoteTable::~RemoteTable() {
+        clear_cache();
+    }
+
+    long long RemoteTable::find_column(const char *name) const {
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            if (columns_[i] == name) {
+                return static_cast<long long>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool RemoteTable::find_columns(const std::vector<std::string> &cols, std::vector<long long> &indexes) const {
+        indexes.clear();
+        for (auto const &name : cols) {
+            long long col = find_column(name.c_str());
+            if (col < 0) {
+                fprintf(stderr, "[kdb+] No column %s in %s.\n", name.c_str(), name_.c_str());
+                return false;
+            }
+            indexes.push_back(col);
+        }
+        return true;
+    }
+
+    K RemoteTable::fetch(const std::vector<long long> &cols, long long begin, long long end) {
+        K names = ktn(11, static_cast<J>(cols.size()));
+        for (size_t i = 0; i < cols.size(); ++i) {
+            kS(names)[i] = ss(const_cast<S>(columns_[cols[i]].c_str()));
+        }
+        K range = ktn(7, 2);
+        kJ(range)[0] = begin;
+        kJ(range)[1] = end - begin;
+        Result res = kcon_.sync(kFetchQuery, {Result(ks(const_cast<S>(name_.c_str())), false),
+                                              Result(range, false), Result(names, false)});
+        ++stats_.round_trips;
+
+        K x = internal::Access::k(res);
+        bool ok = x != nullptr && 98 == x->t && kK(x->k)[1]->n == static_cast<J>(cols.size());
+        for (long long i = 0; ok && i < kK(x->k)[1]->n; ++i) {
+            ok = kK(kK(x->k)[1])[i]->n == end - begin;
+        }
+        if (!ok) {
+            fprintf(stderr, "[kdb+] Failed to fetch columns of %s.\n", name_.c_str());
+            return nullptr;
+        }
+        return internal::inc_ref(x);
+    }
+
+    bool RemoteTable::load(std::vector<long long> cols) {
+        if (!valid()) {
+            return false;
+        }
+        for (size_t i = 0; i < hinted_.size(); ++i) {
+            if (hinted_[i]) {
+                cols.push_back(static_cast<long long>(i));
+            }
+        }
+        std::sort(cols.begin(), cols.end());
+        cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+        cols.erase(std::remove_if(cols.begin(), cols.end(), [this](long long col) { return cache_[col].col != nullptr; }),
+                   cols.end());
+        if (cols.empty()) {
+            return true;
+        }
+
+        K x = fetch(cols, 0, nrow_);
+        if (nullptr == x) {
+            return false;
+        }
+        K values = kK(x->k)[1];
+        ++clock_;
+        for (size_t i = 0; i < cols.size(); ++i) {
+            Entry &entry = cache_[cols[i]];
+            entry.col = internal::inc_ref(kK(values)[i]);
+            entry.bytes = bytes(entry.col);
+            entry.used = clock_;
+            cached_bytes_ += entry.bytes;
+            hinted_[cols[i]] = false;
+        }
+        stats_.columns_fetched += cols.size();
+        internal::dec_ref(x);
+        return true;
+    }
+
+    void RemoteTable::hint(const std::vector<std::string> &cols) {
+        std::vector<long long> indexes;
+        find_columns(cols, indexes);
+        for (long long col : indexes) {
+            hinted_[col] = cache_[col].col == nullptr;
+        }
+    }
+
+    bool RemoteTable::prefetch(const std::vector<std::string> &cols) {
+        std::vector<long long> indexes;
+        if (!find_columns(cols, indexes) || !load(indexes)) {
+            return false;
+        }
+        trim();
+        return true;
+    }
+
+    Result RemoteTable::column(long long col) {
+        if (col < 0 || col >= ncol()) {
+            fprintf(stderr, "[kdb+] No column %lld in %s.\n", col, name_.c_str());
+            return Result(nullptr);
+        } else if (!load({col})) {
+            return Result(nullptr);
+        }
+        Result res(cache_[col].col);
+        cache_[col].used = ++clock_;
+        trim();
+        return res;
+    }
+
+    Result RemoteTable::column(const char *name) {
+        long long col = find_column(name);
+        if (col < 0) {
+            fprintf(stderr, "[kdb+] No column %s in %s.\n", name, name_.c_str());
+            return Result(nullptr);
+        }
+        return column(col);
+    }
+
+    Result RemoteTable::select(const std::vector<std::string> &cols) {
+        std::vector<long long> indexes;
+        if (!find_columns(cols, indexes) || !load(indexes)) {
+            return Result(nullptr);
+        }
+        std::vector<S> names;
+        std::vector<K> values;
+        ++clock_;
+        for (long long col : indexes) {
+            names.push_back(ss(const_cast<S>(columns_[col].c_str())));
+            values.push_back(internal::inc_ref(cache_[col].col));
+            cache_[col].used = clock_;
+        }
+        Result res(internal::make_table(names, values), false);
+        trim();
+        return res;
+    }
+
+    Result RemoteTable::rows(long long begin, long long end, const std::vector<std::string> &cols) {
+        std::vector<long long> indexes;
+        if (!valid() || !find_columns(cols, indexes)) {
+            return Result(nullptr);
+        }
+        begin = std::max(0LL, std::min(begin, nrow_));
+        end = std::max(begin, std::min(end, nrow_));
+
+        std::vector<long long> missing;
+        for (long long col : indexes) {
+            if (nullptr == cache_[col].col) {
+                missing.push_back(col);
+            }
+        }
+        K part = nullptr;
+        if (!missing.empty() && nullptr == (part = fetch(missing, begin, end))) {
+            return Result(nullptr);
+        }
+
+        std::vector<S> names;
+        std::vector<K> values;
+        ++clock_;
+        for (long long col : indexes) {
+            names.push_back(ss(const_cast<S>(columns_[col].c_str())));
+            if (cache_[col].col != nullptr) {
+                values.push_back(internal::slice(cache_[col].col, begin, end));
+                cache_[col].used = clock_;
+            } else {
+                // Fetched in the order of missing
+                size_t j = static_cast<size_t>(std::find(missing.begin(), missing.end(), col) - missing.begin());
+                values.push_back(internal::inc_ref(kK(kK(part->k)[1])[j]));
+            }
+        }
+        if (part != nullptr) {
+            internal::dec_ref(part);
+        }
+        return Result(internal::make_table(names, values), false);
+    }
+
+    void RemoteTable::set_cache_limit(size_t bytes) {
+        cache_limit_ = bytes;
+        trim();
+    }
+
+    void RemoteTable::evict(long long col) {
+        Entry &entry = cache_[col];
+        internal::dec_ref(entry.col);
+        cached_bytes_ -= entry.bytes;
+        entry = Entry();
+        ++stats_.evicted;
+    }
+
+    void RemoteTable::clear_cache() {
+        for (size_t i = 0; i < cache_.size(); ++i) {
+            if (cache_[i].col != nullptr) {
+                evict(static_cast<long long>(i));
+            }
+        }
+    }
+
+    void RemoteTable::trim() {
+        while (cache_limit_ > 0 && cached_bytes_ > cache_limit_) {
+            long long oldest = -1;
+            for (size_t i = 0; i < cache_.size(); ++i) {
+                if (cache_[i].col != nullptr && (oldest < 0 || cache_[i].used < cache_[oldest].used)) {
+                    oldest = static_cast<long long>(i);
+                }
+            }
+            evict(oldest);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/**
+ * @brief   Lazy handle on a table of a kdb+ server, fetching columns on demand
+ *
+ * @file    kdb_remote.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_REMOTE_H__
+#define __KDB_REMOTE_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <string>
+#include <vector>
+#include "../external/k.h"
+#include "kdb_connector.h"
+#include "kdb_result.h"
+
+namespace kdb {
+
+    /**
+     * @brief   A table on the server, fetched column by column. Only the schema and the row
+     *          count are fetched up front; each column is fetched the first time it is read,
+     *          together with the columns hinted at, and kept in a local cache. Wide tables
+     *          read a few columns without transferring the others.
+     *
+     *          RemoteTable trade(kcon, "trade");
+     *          trade.hint({"px", "sz"});
+     *          Vector<Type::Float> px = trade.column("px").get_vector<Type::Float>();    // fetches px and sz
+     *
+     *          The row count is taken with the schema: rows appended later are not read.
+     *          Like the Connector, a RemoteTable is used from one thread at a time.
+     */
+    class RemoteTable {
+    public:
+        struct Stats {
+            unsigned long long round_trips;     // schema included
+            unsigned long long columns_fetched;
+            unsigned long long evicted;         // columns dropped from the cache
+        };
+
+        /**
+         * @brief       Fetch the schema and row count of a table
+         *
+         * @param kcon  connection, must outlive the RemoteTable
+         * @param name  name of a global table, in-memory, splayed or partitioned
+         */
+        RemoteTable(Connector &kcon, const char *name);
+        ~RemoteTable();
+
+        RemoteTable(const RemoteTable &) = delete;
+        RemoteTable &operator=(const RemoteTable &) = delete;
+
+        /**
+         * @brief   Whether the schema was fetched
+         */
+        inline bool valid() const { return nrow_ >= 0; }
+
+        inline long long nrow() const { return nrow_; }
+        inline long long ncol() const { return static_cast<long long>(columns_.size()); }
+
+        /**
+         * @brief   Column names
+         */
+        inline const std::vector<std::string> &columns() const { return columns_; }
+
+        /**
+         * @brief   Type of a column as in q meta, e.g., 'j' for long, 'C' for strings
+         */
+        inline char type(long long col) const { return types_[col]; }
+
+        /**
+         * @brief       Find a column by name
+         *
+         * @return long long    column index, or -1 if there is no such column
+         */
+        long long find_column(const char *name) const;
+
+        /**
+         * @brief       Columns about to be read: they are fetched with the next column fetch,
+         *              in the same round trip
+         */
+        void hint(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Fetch the columns not cached yet in one round trip
+         *
+         * @return false    no such column or network error
+         */
+        bool prefetch(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Whole column, fetched on first access
+         *
+         * @param col   column index
+         * @return Result   vector, or Result(nullptr) on error
+         */
+        Result column(long long col);
+
+        /**
+         * @brief       Whole column, fetched on first access
+         *
+         * @param name  column name
+         * @return Result   vector, or Result(nullptr) on error
+         */
+        Result column(const char *name);
+
+        /**
+         * @brief       Table of some columns, fetching those not cached yet in one round trip
+         *
+         * @param cols  column names
+         * @return Result   table, or Result(nullptr) on error
+         */
+        Result select(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Rows [begin, end) of some columns. Cached columns are sliced locally, the
+         *              others are fetched for these rows only and not cached.
+         *
+         * @param cols  column names
+         * @return Result   table, or Result(nullptr) on error
+         */
+        Result rows(long long begin, long long end, const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Bound the cache, evicting the least recently read columns beyond it
+         *
+         * @param bytes size of the cached columns at most, 0 for no limit (default)
+         */
+        void set_cache_limit(size_t bytes);
+
+        inline size_t cached_bytes() const { return cached_bytes_; }
+
+        /**
+         * @brief   Drop all cached columns
+         */
+        void clear_cache();
+
+        inline Stats stats() const { return stats_; }
+
+    private:
+        struct Entry {
+            K col = nullptr;
+            size_t bytes = 0;
+            unsigned long long used = 0;    // clock of the last read
+        };
+
+        bool find_columns(const std::vector<std::string> &cols, std::vector<long long> &indexes) const;
+        K fetch(const std::vector<long long> &cols, long long begin, long long end);
+        bool load(std::vector<long long> cols);
+        void evict(long long col);
+        void trim();
+
+        Connector &kcon_;
+        std::string name_;
+        long long nrow_ = -1;
+        std::vector<std::string> columns_;
+        std::string types_;
+        std::vector<Entry> cache_;
+        std::vector<bool> hinted_;
+        size_t cached_bytes_ = 0;
+        size_t cache_limit_ = 0;
+        unsigned long long clock_ = 0;
+        Stats stats_ = {0, 0, 0};
+    };
+}
+
+#endif // __KDB_REMOTE_H__
@@ -6,20 +6,22 @@
  * @date    2018-06-27
  */
 
+#include "kdb_memory.h"
 #include "kdb_table.h"
+#include "kdb_dictionary.h"
 #include "kdb_result.h"
 
 namespace kdb {
     Result::Result(K res, bool inc_ref_count) {
         res_ = res;
         if (inc_ref_count && res_) {
-            r1(res_);
+            internal::inc_ref(res_);
         }
     }
 
     Result::~Result() {
         if (res_) {
-            r0(res_);   // Reduce reference count
+            internal::dec_ref(res_);   // Reduce reference count
             res_ = nullptr; // Avoid double free
         }
     }
@@ -28,7 +30,7 @@ namespace kdb {
     Result::Result(const Result &r) {
         res_ = r.res_;
         if (res_) {
-            r1(res_);  // Increment reference count
+            internal::inc_ref(res_);  // Increment reference count
         }
     }
 
@@ -42,11 +44,11 @@ namespace kdb {
     Result & Result::operator = (const Result &r) {
         if (this != &r) {
             if (res_) {
-                r0(res_);  // Reduce reference count
+                internal::dec_ref(res_);  // Reduce reference count
             }
             res_ = r.res_;
             if (res_) {
-                r1(res_);  // Increase reference count
+                internal::inc_ref(res_);  // Increase reference count
             }
         }
         return *this;
@@ -56,6 +58,14 @@ namespace kdb {
         return Table(*this);
     }
 
+    Dictionary Result::get_dictionary() const {
+        return Dictionary(*this);
+    }
+
+    KeyedTable Result::get_keyed_table() const {
+        return KeyedTable(*this);
+    }
+
     std::ostream &operator<<(std::ostream &os, K const &res) {
         if (res) {
             int idx;
@@ -186,7 +196,10 @@ namespace kdb {
             } else if (res_->t == 98) {
                 return StructType::Table;
             } else if (res_->t == 99) {
-                return StructType::Dictionary; // TODO identify KeyedTable
+                if (kK(res_)[0]->t == 98 && kK(res_)[1]->t == 98) {
+                    return StructType::KeyedTable;
+                }
+                return StructType::Dictionary;
             }
         }
 
@@ -9,11 +9,14 @@
 #ifndef __KDB_RESULT_H__
 #define __KDB_RESULT_H__
 
+#include <ostream>
 #include "kdb_type.h"
 #include "kdb_vector.h"
 
 namespace kdb {
     class Table;
+    class Dictionary;
+    class KeyedTable;
     
     class Result {
     public:
@@ -26,8 +29,11 @@ namespace kdb {
         
         friend std::ostream &operator<<(std::ostream &os, const Result &result);
         friend class kdb::Table;
+        friend class kdb::Dictionary;
+        friend class kdb::KeyedTable;
 
         template<Type> friend class kdb::Vector;
+        friend struct internal::Access;
 
         /**
          * @brief   Get type of the result, see enum class Type for all types.
@@ -80,6 +86,22 @@ namespace kdb {
          */
         kdb::Table get_table() const;
 
+        /**
+         * @brief   Get the dictionary object. Undefined behavior if the result is not a dictionary.
+         *          Use struct_type() to check if the result is a dictionary.
+         * 
+         * @return  kdb::Dictionary 
+         */
+        kdb::Dictionary get_dictionary() const;
+
+        /**
+         * @brief   Get the keyed table object. Undefined behavior if the result is not a keyed table.
+         *          Use struct_type() to check if the result is a keyed table.
+         * 
+         * @return  kdb::KeyedTable 
+         */
+        kdb::KeyedTable get_keyed_table() const;
+
         /**
          * @brief   Get the vector object. Undefined behavior if the result is not a vector.
          *          Use struct_type() to check if the result is a vector.
@@ -0,0 +1,85 @@
+/**
+ * @brief   Rolling-window kernels over kdb+ vectors, in batch and incrementally
+ *
+ * @file    kdb_rolling.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include "kdb_rolling.h"
+
+namespace kdb {
+
+    RollingSum::RollingSum(size_t window)
+        : ring_(std::max<size_t>(1, window), std::numeric_limits<double>::quiet_NaN()) {}
+
+    double RollingSum::update(double x) {
+        if (rows_ >= ring_.size()) {
+            double old = ring_[pos_];
+            if (old == old) {
+                sum_.add(-old);
+                --count_;
+            }
+        }
+        ring_[pos_] = x;
+        if (x == x) {
+            sum_.add(x);
+            ++count_;
+        }
+        if (0 == count_) {
+            sum_.reset();       // an empty window sums to exactly 0
+        }
+        pos_ = pos_ + 1 == ring_.size() ? 0 : pos_ + 1;
+        ++rows_;
+        return sum();
+    }
+
+    double RollingSum::sum() const {
+        return sum_.value();
+    }
+
+    double RollingSum::mean() const {
+        return count_ ? sum_.value() / static_cast<double>(count_) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    void RollingSum::reset() {
+        std::fill(ring_.begin(), ring_.end(), std::numeric_limits<double>::quiet_NaN());
+        pos_ = rows_ = count_ = 0;
+        sum_.reset();
+    }
+
+    Ewma::Ewma(double alpha) : alpha_(alpha), value_(std::numeric_limits<double>::quiet_NaN()) {}
+
+    double Ewma::update(double x) {
+        if (x != x) {
+            return value_;
+        }
+        value_ = value_ != value_ ? x : value_ + alpha_ * (x - value_);
+        return value_;
+    }
+
+    void Ewma::reset() {
+        value_ = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    RollingVwap::RollingVwap(size_t window) : notional_(window), volume_(window) {}
+
+    double RollingVwap::update(double px, double sz) {
+        if (px != px || sz != sz) {
+            px = sz = std::numeric_limits<double>::quiet_NaN();
+        }
+        notional_.update(px * sz);
+        volume_.update(sz);
+        return value();
+    }
+
+    double RollingVwap::value() const {
+        double v = volume_.sum();
+        return v != 0 ? notional_.sum() / v : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    void RollingVwap::reset() {
+        notional_.reset();
+        volume_.reset();
+    }
+}
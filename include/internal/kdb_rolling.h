@@ -0,0 +1,358 @@
+/**
+ * @brief   Rolling-window kernels over kdb+ vectors, in batch and incrementally
+ *
+ * @file    kdb_rolling.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_ROLLING_H__
+#define __KDB_ROLLING_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kdb_type.h"
+#include "kdb_parallel.h"
+#include "kdb_vector.h"
+
+namespace kdb {
+    namespace internal {
+
+        // Rows per parallel chunk of a batch kernel
+        constexpr long long kRollingGrain = 1 << 16;
+
+        /**
+         * @brief   Neumaier's compensated sum: the rounding error of every addition is carried
+         *          apart, so adding and removing values of a window for millions of rows does
+         *          not drift
+         */
+        class CompensatedSum {
+        public:
+            inline void add(double x) {
+                double t = sum_ + x;
+                if (std::fabs(sum_) >= std::fabs(x)) {
+                    c_ += (sum_ - t) + x;
+                } else {
+                    c_ += (x - t) + sum_;
+                }
+                sum_ = t;
+            }
+
+            inline double value() const { return sum_ + c_; }
+            inline void reset() { sum_ = c_ = 0; }
+
+        private:
+            double sum_ = 0;
+            double c_ = 0;
+        };
+
+        // kdb+ null of a C type: NaN for floating-point types, the lowest value for the others
+        template<typename V>
+        constexpr V null_of() {
+            if constexpr (std::is_floating_point<V>::value) {
+                return std::numeric_limits<V>::quiet_NaN();
+            } else {
+                return std::numeric_limits<V>::min();
+            }
+        }
+
+        template<typename V>
+        inline bool is_null(V x) {
+            if constexpr (std::is_floating_point<V>::value) {
+                return x != x;
+            } else if constexpr (std::is_same<V, bool>::value || sizeof(V) == 1) {
+                return false;       // booleans and bytes have no null
+            } else {
+                return x == std::numeric_limits<V>::min();
+            }
+        }
+
+        // Element as double, NaN for nulls
+        template<typename V>
+        inline double as_double(V x) {
+            if constexpr (std::is_same<V, bool>::value) {
+                return x ? 1.0 : 0.0;
+            } else if constexpr (sizeof(V) == 1) {
+                return static_cast<double>(static_cast<unsigned char>(x));
+            } else {
+                return is_null(x) ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(x);
+            }
+        }
+
+        /**
+         * @brief       Run fn(warm, begin, end) over chunks of [0, n) in parallel. A windowed
+         *              kernel feeds rows [warm, begin) to fill its window, then outputs [begin, end).
+         *              Chunks are at least 8 windows long, so warming up costs little.
+         */
+        template<typename F>
+        void windowed(long long n, size_t window, F &&fn, unsigned max_threads = 0) {
+            long long w = std::max<long long>(1, static_cast<long long>(window));
+            long long grain = std::max(kRollingGrain, 8 * w);
+            parallel_for(n, grain, [&](long long begin, long long end) {
+                fn(std::max(0LL, begin - w + 1), begin, end);
+            }, max_threads);
+        }
+    }
+
+    /**
+     * @brief   Sum and mean of the last window rows, like q msum and mavg. Nulls are
+     *          skipped: the mean is over the non-null values in the window.
+     *          O(1) per update with a compensated sum.
+     */
+    class RollingSum {
+    public:
+        /**
+         * @param window    rows in the window, at least 1
+         */
+        explicit RollingSum(size_t window);
+
+        /**
+         * @brief       Add the next row, dropping the oldest one from a full window
+         *
+         * @param x     value, NaN for null
+         * @return double   sum of the window
+         */
+        double update(double x);
+
+        double sum() const;
+
+        /**
+         * @return double   mean of the non-null values, NaN if none
+         */
+        double mean() const;
+
+        /**
+         * @return size_t   non-null values in the window
+         */
+        inline size_t count() const { return count_; }
+        inline size_t window() const { return ring_.size(); }
+        void reset();
+
+    private:
+        std::vector<double> ring_;      // last window rows
+        size_t pos_ = 0;                // slot of the oldest row
+        size_t rows_ = 0;
+        size_t count_ = 0;
+        internal::CompensatedSum sum_;
+    };
+
+    /**
+     * @brief   Exponentially weighted moving average: the first non-null value, then
+     *          alpha * x + (1 - alpha) * previous. Equal to q ema on data without nulls.
+     *          Unlike q ema, where a null makes every later value null, nulls are skipped
+     *          and leave the average unchanged.
+     */
+    class Ewma {
+    public:
+        /**
+         * @param alpha     weight of the new value, in (0, 1]
+         */
+        explicit Ewma(double alpha);
+
+        /**
+         * @param x     value, NaN for null
+         * @return double   average so far, NaN before the first non-null value
+         */
+        double update(double x);
+
+        inline double value() const { return value_; }
+        void reset();
+
+    private:
+        double alpha_;
+        double value_;
+    };
+
+    /**
+     * @brief   Volume-weighted average price of the last window trades. Trades with a null
+     *          price or size are skipped.
+     */
+    class RollingVwap {
+    public:
+        explicit RollingVwap(size_t window);
+
+        /**
+         * @return double   sum(px * sz) % sum(sz) over the window, NaN if no volume
+         */
+        double update(double px, double sz);
+
+        double value() const;
+        void reset();
+
+    private:
+        RollingSum notional_;
+        RollingSum volume_;
+    };
+
+    /**
+     * @brief   Minimum or maximum of the last window rows, like q mmin and mmax, with a
+     *          monotonic deque: amortized O(1) per update whatever the window. Nulls are skipped.
+     *
+     * @tparam V        C type of the values
+     * @tparam Compare  std::less for the minimum, std::greater for the maximum
+     */
+    template<typename V, typename Compare>
+    class RollingExtreme {
+    public:
+        static_assert(std::is_arithmetic<V>::value, "rolling min and max need numeric or temporal values");
+
+        explicit RollingExtreme(size_t window) : window_(static_cast<long long>(std::max<size_t>(1, window))) {}
+
+        /**
+         * @return V    extreme of the window, null if all its values are null
+         */
+        V update(V x) {
+            ++row_;
+            if (!deque_.empty() && deque_.front().first <= row_ - window_) {
+                deque_.pop_front();
+            }
+            if (!internal::is_null(x)) {
+                // Values no better than x can never be the extreme again
+                while (!deque_.empty() && !Compare()(deque_.back().second, x)) {
+                    deque_.pop_back();
+                }
+                deque_.emplace_back(row_, x);
+            }
+            return value();
+        }
+
+        inline V value() const { return deque_.empty() ? internal::null_of<V>() : deque_.front().second; }
+        inline size_t window() const { return static_cast<size_t>(window_); }
+
+        void reset() {
+            deque_.clear();
+            row_ = 0;
+        }
+
+    private:
+        long long window_;
+        long long row_ = 0;
+        std::deque<std::pair<long long, V>> deque_;     // row and value, front is the extreme
+    };
+
+    template<typename V>
+    using RollingMin = RollingExtreme<V, std::less<V>>;
+
+    template<typename V>
+    using RollingMax = RollingExtreme<V, std::greater<V>>;
+
+    /**
+     * @brief       Moving sum over a whole vector or a slice of it, e.g., msum[window; v].
+     *              Long vectors are computed in parallel chunks.
+     *
+     * @param v     numeric or temporal vector
+     * @param window    rows in the window
+     * @param out   v.size() sums
+     */
+    template<Type T>
+    void rolling_sum(const Vector<T> &v, size_t window, double *out) {
+        internal::windowed(v.size(), window, [&](long long warm, long long begin, long long end) {
+            RollingSum k(window);
+            for (long long i = warm; i < begin; ++i) {
+                k.update(internal::as_double(v[i]));
+            }
+            for (long long i = begin; i < end; ++i) {
+                out[i] = k.update(internal::as_double(v[i]));
+            }
+        });
+    }
+
+    /**
+     * @brief       Moving average, e.g., mavg[window; v]
+     *
+     * @param out   v.size() averages, NaN where the window has no value
+     */
+    template<Type T>
+    void rolling_mean(const Vector<T> &v, size_t window, double *out) {
+        internal::windowed(v.size(), window, [&](long long warm, long long begin, long long end) {
+            RollingSum k(window);
+            for (long long i = warm; i < begin; ++i) {
+                k.update(internal::as_double(v[i]));
+            }
+            for (long long i = begin; i < end; ++i) {
+                k.update(internal::as_double(v[i]));
+                out[i] = k.mean();
+            }
+        });
+    }
+
+    /**
+     * @brief       Moving minimum, e.g., mmin[window; v]
+     *
+     * @param out   v.size() values, null where the window has no value
+     */
+    template<Type T>
+    void rolling_min(const Vector<T> &v, size_t window, typename c_type<T>::type *out) {
+        internal::windowed(v.size(), window, [&](long long warm, long long begin, long long end) {
+            RollingMin<typename c_type<T>::type> k(window);
+            for (long long i = warm; i < begin; ++i) {
+                k.update(v[i]);
+            }
+            for (long long i = begin; i < end; ++i) {
+                out[i] = k.update(v[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief       Moving maximum, e.g., mmax[window; v]
+     *
+     * @param out   v.size() values, null where the window has no value
+     */
+    template<Type T>
+    void rolling_max(const Vector<T> &v, size_t window, typename c_type<T>::type *out) {
+        internal::windowed(v.size(), window, [&](long long warm, long long begin, long long end) {
+            RollingMax<typename c_type<T>::type> k(window);
+            for (long long i = warm; i < begin; ++i) {
+                k.update(v[i]);
+            }
+            for (long long i = begin; i < end; ++i) {
+                out[i] = k.update(v[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief       Exponentially weighted moving average, like ema[alpha; v] but skipping
+     *              nulls, see Ewma. Sequential: every output depends on all the rows before it.
+     *
+     * @param out   v.size() averages
+     */
+    template<Type T>
+    void ewma(const Vector<T> &v, double alpha, double *out) {
+        Ewma k(alpha);
+        for (long long i = 0; i < v.size(); ++i) {
+            out[i] = k.update(internal::as_double(v[i]));
+        }
+    }
+
+    /**
+     * @brief       Rolling VWAP of the last window trades, e.g., over the px and size columns of a
+     *              trade table
+     *
+     * @param px    prices
+     * @param sz    sizes, as long as px
+     * @param out   min(px.size(), sz.size()) values, NaN where the window has no volume
+     */
+    template<Type P, Type S>
+    void rolling_vwap(const Vector<P> &px, const Vector<S> &sz, size_t window, double *out) {
+        internal::windowed(std::min(px.size(), sz.size()), window, [&](long long warm, long long begin, long long end) {
+            RollingVwap k(window);
+            for (long long i = warm; i < begin; ++i) {
+                k.update(internal::as_double(px[i]), internal::as_double(sz[i]));
+            }
+            for (long long i = begin; i < end; ++i) {
+                out[i] = k.update(internal::as_double(px[i]), internal::as_double(sz[i]));
+            }
+        });
+    }
+}
+
+#endif // __KDB_ROLLING_H__
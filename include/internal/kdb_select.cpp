@@ -0,0 +1,198 @@
+/**
+ * @brief   Builder of kdb+ functional selects, sent as parse trees rather than q strings
+ *
+ * @file    kdb_select.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstdio>
+#include <mutex>
+#include <unordered_set>
+#include "kdb_column.h"
+#include "kdb_memory.h"
+#include "kdb_select.h"
+
+namespace kdb {
+
+    namespace {
+        // c.o cannot serialize q primitives, so function nodes carry the q source of the function
+        // in head position. .kdbcpp.fn resolves a head: q keywords from .q and other names with
+        // get, both by symbol, anything else parsed once and kept in .kdbcpp.fns.
+        const char *kSelectName = ".kdbcpp.select";
+        const char *kSelectInstall =
+            ".kdbcpp.fns:(0#`)!();"
+            ".kdbcpp.fn:{s:`$x;$[s in key .q;.q s;x[0] in .Q.a,.Q.A,\".\";get s;"
+            "s in key .kdbcpp.fns;.kdbcpp.fns s;[.kdbcpp.fns[s]:f:value x;f]]};"
+            ".kdbcpp.select:{[t;c;b;a]"
+            "f:{$[(0h=type x) and 10h=type first x;(.kdbcpp.fn first x),.z.s each 1_x;x]};"
+            "?[t;f each c;$[99h=type b;key[b]!f each value b;b];$[99h=type a;key[a]!f each value a;a]]}";
+
+        // Connections the evaluator is installed on, by Connector::connection_id()
+        std::mutex installed_mutex;
+        std::unordered_set<unsigned long long> installed;
+
+        bool install_evaluator(Connector &kcon) {
+            {
+                std::lock_guard<std::mutex> lock(installed_mutex);
+                if (installed.count(kcon.connection_id())) {
+                    return true;
+                }
+            }
+            Result res = kcon.sync(kSelectInstall);
+            if (nullptr == internal::Access::k(res)) {
+                fprintf(stderr, "[kdb+] Failed to install %s.\n", kSelectName);
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(installed_mutex);
+            installed.insert(kcon.connection_id());
+            return true;
+        }
+    }
+
+    Expr Expr::column(const char *name) {
+        return Expr(ks(const_cast<S>(name)));
+    }
+
+    Expr Expr::symbol(const char *s) {
+        // A symbol atom in a parse tree is a column name, a one-item vector is the constant
+        K x = ktn(11, 1);
+        kS(x)[0] = ss(const_cast<S>(s));
+        return Expr(x);
+    }
+
+    Expr Expr::symbols(const std::vector<std::string> &s) {
+        K x = ktn(11, static_cast<J>(s.size()));
+        for (size_t i = 0; i < s.size(); ++i) {
+            kS(x)[i] = ss(const_cast<S>(s[i].c_str()));
+        }
+        return Expr(knk(1, x));    // enlist: a symbol vector would be a list of column names
+    }
+
+    Expr Expr::string(const char *s) {
+        return Expr(kp(const_cast<S>(s)));
+    }
+
+    Expr Expr::call(const char *fn, const std::vector<Expr> &args) {
+        K x = ktn(0, static_cast<J>(args.size() + 1));
+        kK(x)[0] = kp(const_cast<S>(fn));
+        for (size_t i = 0; i < args.size(); ++i) {
+            kK(x)[i + 1] = internal::inc_ref(internal::Access::k(args[i].tree_));
+        }
+        return Expr(x);
+    }
+
+    Expr operator==(const Expr &x, const Expr &y) { return Expr::call("=", {x, y}); }
+    Expr operator!=(const Expr &x, const Expr &y) { return Expr::call("<>", {x, y}); }
+    Expr operator<(const Expr &x, const Expr &y) { return Expr::call("<", {x, y}); }
+    Expr operator<=(const Expr &x, const Expr &y) { return Expr::call("<=", {x, y}); }
+    Expr operator>(const Expr &x, const Expr &y) { return Expr::call(">", {x, y}); }
+    Expr operator>=(const Expr &x, const Expr &y) { return Expr::call(">=", {x, y}); }
+    Expr operator+(const Expr &x, const Expr &y) { return Expr::call("+", {x, y}); }
+    Expr operator-(const Expr &x, const Expr &y) { return Expr::call("-", {x, y}); }
+    Expr operator*(const Expr &x, const Expr &y) { return Expr::call("*", {x, y}); }
+    Expr operator/(const Expr &x, const Expr &y) { return Expr::call("%", {x, y}); }
+    Expr operator&&(const Expr &x, const Expr &y) { return Expr::call("&", {x, y}); }
+    Expr operator||(const Expr &x, const Expr &y) { return Expr::call("|", {x, y}); }
+    Expr operator!(const Expr &x) { return Expr::call("not", {x}); }
+
+    Expr compare(const Expr &x, Op op, const Expr &y) {
+        switch (op) {
+        case Op::Eq: return x == y;
+        case Op::Ne: return x != y;
+        case Op::Lt: return x < y;
+        case Op::Le: return x <= y;
+        case Op::Gt: return x > y;
+        case Op::Ge: return x >= y;
+        }
+        return x == y;
+    }
+
+    Expr agg(Agg agg, const Expr &x) {
+        switch (agg) {
+        case Agg::Sum: return Expr::call("sum", {x});
+        case Agg::Avg: return Expr::call("avg", {x});
+        case Agg::Min: return Expr::call("min", {x});
+        case Agg::Max: return Expr::call("max", {x});
+        case Agg::Count: return Expr::call("count", {x});
+        case Agg::First: return Expr::call("first", {x});
+        case Agg::Last: return Expr::call("last", {x});
+        }
+        return x;
+    }
+
+    Select::Select(const char *table) : table_(table) {}
+
+    Select &Select::where(const Expr &pred) {
+        where_.push_back(pred);
+        tree_.clear();
+        return *this;
+    }
+
+    Select &Select::select(const char *name, const Expr &x) {
+        select_.emplace_back(name, x);
+        tree_.clear();
+        return *this;
+    }
+
+    Select &Select::select(const std::vector<std::string> &cols) {
+        for (auto const &name : cols) {
+            select(name.c_str(), Expr::column(name.c_str()));
+        }
+        return *this;
+    }
+
+    Select &Select::by(const char *name, const Expr &x) {
+        by_.emplace_back(name, x);
+        tree_.clear();
+        return *this;
+    }
+
+    Select &Select::by(const std::vector<std::string> &cols) {
+        for (auto const &name : cols) {
+            by(name.c_str(), Expr::column(name.c_str()));
+        }
+        return *this;
+    }
+
+    // Dictionary of output names to parse trees, as the b and a arguments of ?
+    K Select::columns(const std::vector<std::pair<std::string, Expr>> &cols) {
+        K names = ktn(11, static_cast<J>(cols.size()));
+        K trees = ktn(0, static_cast<J>(cols.size()));
+        for (size_t i = 0; i < cols.size(); ++i) {
+            kS(names)[i] = ss(const_cast<S>(cols[i].first.c_str()));
+            kK(trees)[i] = internal::inc_ref(internal::Access::k(cols[i].second.tree_));
+        }
+        return xD(names, trees);
+    }
+
+    const std::vector<Result> &Select::tree() const {
+        if (!tree_.empty()) {
+            return tree_;
+        }
+        K c = ktn(0, static_cast<J>(where_.size()));
+        for (size_t i = 0; i < where_.size(); ++i) {
+            kK(c)[i] = internal::inc_ref(internal::Access::k(where_[i].tree_));
+        }
+        tree_.emplace_back(ks(const_cast<S>(table_.c_str())), false);
+        tree_.emplace_back(c, false);
+        tree_.emplace_back(by_.empty() ? kb(0) : columns(by_), false);
+        tree_.emplace_back(select_.empty() ? ktn(0, 0) : columns(select_), false);
+        return tree_;
+    }
+
+    Result Select::run(Connector &kcon) const {
+        if (!install_evaluator(kcon)) {
+            return Result(nullptr);
+        }
+        unsigned long long id = kcon.connection_id();
+        Result res = kcon.call(kSelectName, tree());
+        if (nullptr == internal::Access::k(res) && kcon.connection_id() != id && kcon.reconnect_policy().replay_sync) {
+            // Reconnected during the call, which was replayed before the evaluator was installed
+            if (install_evaluator(kcon)) {
+                res = kcon.call(kSelectName, tree());
+            }
+        }
+        return res;
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * @brief   Builder of kdb+ functional selects, sent as parse trees rather than q strings
+ *
+ * @file    kdb_select.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_SELECT_H__
+#define __KDB_SELECT_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../external/k.h"
+#include "kdb_type.h"
+#include "kdb_connector.h"
+#include "kdb_query.h"
+#include "kdb_result.h"
+
+namespace kdb {
+    class Select;
+
+    /**
+     * @brief   Node of a q parse tree: a column, a constant or a function applied to nodes.
+     *          Functions are named by their q source, e.g., "=" or "sum", and resolved by the
+     *          server once per connection, so symbols and strings travel as data and never
+     *          need escaping.
+     */
+    class Expr {
+    public:
+        /**
+         * @brief       Constant: bool, byte, short, int, long, real or float by the C++ type
+         */
+        template<typename V, typename = typename std::enable_if<std::is_arithmetic<V>::value>::type>
+        Expr(V v) : tree_(atom(v), false) {}
+
+        /**
+         * @brief       Reference to a column
+         */
+        static Expr column(const char *name);
+
+        /**
+         * @brief       Constant of a kdb+ type, e.g., atom<Type::Timestamp>(nanos)
+         */
+        template<Type T>
+        static Expr atom(typename c_type<T>::type v);
+
+        /**
+         * @brief       Symbol constant, e.g., `IBM
+         */
+        static Expr symbol(const char *s);
+
+        /**
+         * @brief       Symbol vector constant, e.g., `IBM`MSFT for in
+         */
+        static Expr symbols(const std::vector<std::string> &s);
+
+        /**
+         * @brief       String constant, e.g., for like
+         */
+        static Expr string(const char *s);
+
+        /**
+         * @brief       Apply a q function to arguments
+         *
+         * @param fn    q source of the function, e.g., "within", "xbar" or "{x*y}"
+         * @param args  arguments
+         */
+        static Expr call(const char *fn, const std::vector<Expr> &args);
+
+        friend class Select;
+
+    private:
+        explicit Expr(K tree) : tree_(tree, false) {}
+
+        template<typename V>
+        static K atom(V v) {
+            if constexpr (std::is_same<V, bool>::value) {
+                return kb(v);
+            } else if constexpr (std::is_floating_point<V>::value) {
+                return sizeof(V) == 4 ? ke(v) : kf(static_cast<double>(v));
+            } else if constexpr (sizeof(V) == 1) {
+                return kg(static_cast<int>(v));
+            } else if constexpr (sizeof(V) == 2) {
+                return kh(v);
+            } else if constexpr (sizeof(V) == 4) {
+                return ki(static_cast<int>(v));
+            } else {
+                return kj(static_cast<long long>(v));
+            }
+        }
+
+        Result tree_;
+    };
+
+    template<Type T>
+    Expr Expr::atom(typename c_type<T>::type v) {
+        if constexpr (T == Type::Symbol) {
+            return symbol(v);
+        } else {
+            K x = ka(-static_cast<int>(T));
+            std::memcpy(&x->g, &v, sizeof(v));
+            return Expr(x);
+        }
+    }
+
+    inline Expr col(const char *name) { return Expr::column(name); }
+    inline Expr sym(const char *s) { return Expr::symbol(s); }
+
+    Expr operator==(const Expr &x, const Expr &y);
+    Expr operator!=(const Expr &x, const Expr &y);
+    Expr operator<(const Expr &x, const Expr &y);
+    Expr operator<=(const Expr &x, const Expr &y);
+    Expr operator>(const Expr &x, const Expr &y);
+    Expr operator>=(const Expr &x, const Expr &y);
+    Expr operator+(const Expr &x, const Expr &y);
+    Expr operator-(const Expr &x, const Expr &y);
+    Expr operator*(const Expr &x, const Expr &y);
+    Expr operator/(const Expr &x, const Expr &y);      // q %, always float
+    Expr operator&&(const Expr &x, const Expr &y);     // q &, both sides are evaluated
+    Expr operator||(const Expr &x, const Expr &y);     // q |, both sides are evaluated
+    Expr operator!(const Expr &x);
+
+    /**
+     * @brief       Comparison like in the client-side Query
+     */
+    Expr compare(const Expr &x, Op op, const Expr &y);
+
+    /**
+     * @brief       Aggregation like in the client-side Query, e.g., agg(Agg::Sum, col("sz"))
+     */
+    Expr agg(Agg agg, const Expr &x);
+
+    /**
+     * @brief       Typed column: constants compared with it must have exactly its C type, so
+     *              Col<Type::Symbol>("sym") == 5 and Col<Type::Long>("sz") == 5.5 do not
+     *              compile, and a long column takes 5LL rather than 5
+     *
+     * @tparam T    kdb::Type of the column
+     */
+    template<Type T>
+    class Col {
+    public:
+        typedef typename std::conditional<T == Type::Symbol, const char *, typename c_type<T>::type>::type param_type;
+
+        explicit Col(const char *name) : name_(name) {}
+
+        operator Expr() const { return Expr::column(name_.c_str()); }
+
+        Expr operator==(param_type v) const { return compare(*this, Op::Eq, Expr::atom<T>(value(v))); }
+        Expr operator!=(param_type v) const { return compare(*this, Op::Ne, Expr::atom<T>(value(v))); }
+        Expr operator<(param_type v) const { return compare(*this, Op::Lt, Expr::atom<T>(value(v))); }
+        Expr operator<=(param_type v) const { return compare(*this, Op::Le, Expr::atom<T>(value(v))); }
+        Expr operator>(param_type v) const { return compare(*this, Op::Gt, Expr::atom<T>(value(v))); }
+        Expr operator>=(param_type v) const { return compare(*this, Op::Ge, Expr::atom<T>(value(v))); }
+
+        // Constants of another type, e.g., a number for a symbol column or a float for a long one
+        template<typename V>
+        using exact = std::integral_constant<bool, std::is_same<V, param_type>::value
+                                                   || (T == Type::Symbol && std::is_same<V, char *>::value)>;
+        template<typename V>
+        using mismatch = typename std::enable_if<!exact<V>::value>::type;
+
+        template<typename V, typename = mismatch<V>> Expr operator==(V) const = delete;
+        template<typename V, typename = mismatch<V>> Expr operator!=(V) const = delete;
+        template<typename V, typename = mismatch<V>> Expr operator<(V) const = delete;
+        template<typename V, typename = mismatch<V>> Expr operator<=(V) const = delete;
+        template<typename V, typename = mismatch<V>> Expr operator>(V) const = delete;
+        template<typename V, typename = mismatch<V>> Expr operator>=(V) const = delete;
+
+        /**
+         * @brief   lo <= column <= hi, like q within
+         */
+        Expr within(param_type lo, param_type hi) const {
+            return Expr::call("within", {*this, Expr::call("enlist", {Expr::atom<T>(value(lo)), Expr::atom<T>(value(hi))})});
+        }
+
+        template<typename L, typename H, typename = typename std::enable_if<!exact<L>::value || !exact<H>::value>::type>
+        Expr within(L, H) const = delete;
+
+    private:
+        static typename c_type<T>::type value(param_type v) {
+            if constexpr (T == Type::Symbol) {
+                return const_cast<char *>(v);
+            } else {
+                return v;
+            }
+        }
+
+        std::string name_;
+    };
+
+    /**
+     * @brief   Functional select ?[t;c;b;a] on the server, built from parse trees, e.g.,
+     *
+     *          Select q("trade");
+     *          q.where(Col<Type::Symbol>("sym") == "IBM").where(col("px") > 100.0)
+     *           .by({"sym"}).select("volume", agg(Agg::Sum, col("sz")));
+     *          Result r = q.run(kcon);     // select volume:sum sz by sym from trade where sym=`IBM, px>100
+     *
+     *          The query goes as K objects and is built once: running the same Select again
+     *          only serializes it. The evaluator of the trees is installed on the server as
+     *          .kdbcpp.select the first time a Select runs on a connection, and then called by
+     *          name. q keywords and globals in function heads are looked up by symbol; other
+     *          heads, e.g., "=" or "{x*y}", are parsed once per connection.
+     */
+    class Select {
+    public:
+        /**
+         * @param table name of a global table, in-memory, splayed or partitioned
+         */
+        explicit Select(const char *table);
+
+        /**
+         * @brief       Add a constraint. Constraints are applied in order, each on the rows
+         *              left by the previous ones.
+         */
+        Select &where(const Expr &pred);
+
+        /**
+         * @brief       Add an output column, default is all columns
+         */
+        Select &select(const char *name, const Expr &x);
+
+        /**
+         * @brief       Add output columns as they are
+         */
+        Select &select(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Add a group-by key
+         */
+        Select &by(const char *name, const Expr &x);
+
+        /**
+         * @brief       Group by columns as they are
+         */
+        Select &by(const std::vector<std::string> &cols);
+
+        /**
+         * @brief       Run on the server
+         *
+         * @return Result   table, keyed table if grouped, or Result(nullptr) on error
+         */
+        Result run(Connector &kcon) const;
+
+        /**
+         * @brief   The arguments (t; c; b; a) of ?, built on first use and kept until the
+         *          Select changes
+         */
+        const std::vector<Result> &tree() const;
+
+    private:
+        static K columns(const std::vector<std::pair<std::string, Expr>> &cols);
+
+        std::string table_;
+        std::vector<Expr> where_;
+        std::vector<std::pair<std::string, Expr>> by_;
+        std::vector<std::pair<std::string, Expr>> select_;
+        mutable std::vector<Result> tree_;
+    };
+}
+
+#endif // __KDB_SELECT_H__
@@ -0,0 +1,224 @@
+/**
+ * @brief   Local snapshots of results in kdb+ IPC format, for a fast warm start
+ *
+ * @file    kdb_snapshot.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "kdb_column.h"
+#include "kdb_ipc.h"
+#include "kdb_memory.h"
+#include "kdb_parallel.h"
+#include "kdb_snapshot.h"
+
+namespace kdb {
+
+    namespace {
+
+        constexpr char kMagic[8] = {'k', 'd', 'b', 's', 'n', 'a', 'p', '\0'};
+        constexpr uint32_t kVersion = 1;
+        constexpr size_t kChunk = 1 << 20;     // bytes per checksum chunk
+
+        struct SnapshotHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t header_size;
+            uint64_t size;          // bytes of the IPC message that follows
+            uint64_t checksum;
+            int64_t saved;          // nanoseconds since the Unix epoch
+            uint8_t reserved[24];
+        };
+        static_assert(sizeof(SnapshotHeader) == 64, "snapshot header is 64 bytes");
+
+        // 64-bit multiply-xor hash over four independent lanes, fast enough to run at memory
+        // bandwidth on a few threads. Detects corruption, not tampering.
+        uint64_t hash_chunk(const G *p, size_t n, uint64_t seed) {
+            const uint64_t k = 0x9e3779b97f4a7c15ULL;
+            uint64_t h[4] = {seed, seed ^ 1, seed ^ 2, seed ^ 3};
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                for (int l = 0; l < 4; ++l) {
+                    uint64_t w;
+                    std::memcpy(&w, p + i + 8 * l, 8);
+                    h[l] = (h[l] ^ w) * k;
+                    h[l] ^= h[l] >> 29;
+                }
+            }
+            for (; i < n; ++i) {
+                h[0] = (h[0] ^ p[i]) * k;
+            }
+            uint64_t r = n;
+            for (int l = 0; l < 4; ++l) {
+                r = (r ^ h[l]) * k;
+                r ^= r >> 32;
+            }
+            return r;
+        }
+
+        uint64_t checksum(const G *p, size_t n, unsigned max_threads) {
+            long long chunks = static_cast<long long>((n + kChunk - 1) / kChunk);
+            std::vector<uint64_t> hashes(static_cast<size_t>(chunks));
+            internal::parallel_for(chunks, 1, [&](long long b, long long e) {
+                for (long long i = b; i < e; ++i) {
+                    size_t offset = static_cast<size_t>(i) * kChunk;
+                    hashes[i] = hash_chunk(p + offset, std::min(kChunk, n - offset), static_cast<uint64_t>(i));
+                }
+            }, max_threads);
+            return hash_chunk(reinterpret_cast<const G *>(hashes.data()), hashes.size() * sizeof(uint64_t), n);
+        }
+
+        // Last element of a simple column as an atom
+        K last(K col) {
+            if (col->n <= 0 || col->t <= 0 || col->t == 2 || col->t > 19) {
+                return nullptr;
+            }
+            K x = ka(-col->t);
+            if (11 == col->t) {
+                x->s = kS(col)[col->n - 1];
+            } else {
+                int size = internal::type_size(col->t);
+                std::memcpy(&x->g, kG(col) + (col->n - 1) * size, static_cast<size_t>(size));
+            }
+            return x;
+        }
+    }
+
+    bool save_snapshot(const Result &res, const char *path) {
+        K x = internal::Access::k(res);
+        if (nullptr == x) {
+            fprintf(stderr, "[kdb+] Nothing to save to %s.\n", path);
+            return false;
+        }
+        K msg = internal::encode(x, internal::kResponse);
+        if (nullptr == msg) {
+            return false;
+        }
+
+        SnapshotHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.header_size = sizeof(SnapshotHeader);
+        header.size = static_cast<uint64_t>(msg->n);
+        header.checksum = checksum(kG(msg), static_cast<size_t>(msg->n), 0);
+        header.saved = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::string tmp = std::string(path) + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        bool ok = f != nullptr && 1 == fwrite(&header, sizeof(header), 1, f)
+                  && 1 == fwrite(kG(msg), static_cast<size_t>(msg->n), 1, f)
+                  && 0 == fflush(f) && 0 == fsync(fileno(f));
+        if (f != nullptr) {
+            ok = 0 == fclose(f) && ok;
+        }
+        r0(msg);
+        if (!ok || rename(tmp.c_str(), path) != 0) {
+            fprintf(stderr, "[kdb+] Failed to save snapshot %s.\n", path);
+            remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    Result load_snapshot(const char *path, bool verify, unsigned max_threads) {
+        int fd = open(path, O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return Result(nullptr);
+        }
+        size_t mapped = static_cast<size_t>(st.st_size);
+        void *addr = mmap(nullptr, mapped, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (MAP_FAILED == addr) {
+            fprintf(stderr, "[kdb+] Failed to map snapshot %s.\n", path);
+            return Result(nullptr);
+        }
+        madvise(addr, mapped, MADV_WILLNEED);     // read ahead the whole file
+
+        const SnapshotHeader *header = static_cast<const SnapshotHeader *>(addr);
+        const G *msg = static_cast<const G *>(addr) + sizeof(SnapshotHeader);
+        K res = nullptr;
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion
+            || header->header_size != sizeof(SnapshotHeader) || header->size != mapped - sizeof(SnapshotHeader)
+            || header->size < sizeof(internal::Header)) {
+            fprintf(stderr, "[kdb+] %s is not a snapshot of this version.\n", path);
+        } else if (verify && checksum(msg, header->size, max_threads) != header->checksum) {
+            fprintf(stderr, "[kdb+] Snapshot %s is corrupt.\n", path);
+        } else if (msg[2] != 0) {
+            // Compressed by b9: inflate first
+            K raw = internal::decompress(msg, header->size);
+            res = internal::decode(raw, 0, max_threads);
+            if (raw != nullptr) {
+                r0(raw);
+            }
+        } else {
+            res = internal::decode(msg, header->size, max_threads);
+        }
+        munmap(addr, mapped);
+        return Result(res, false);
+    }
+
+    Result refresh_snapshot(Connector &kcon, const char *path, const char *full, const char *delta, const char *col) {
+        Result snap = load_snapshot(path);
+        K x = internal::Access::k(snap);
+        if (nullptr == x || x->t != 98) {
+            Result res = kcon.sync(full);
+            if (internal::Access::k(res) != nullptr) {
+                save_snapshot(res, path);
+            }
+            return res;
+        }
+
+        Table tbl(snap);
+        long long c = tbl.find_column(col);
+        K mark = c < 0 ? nullptr : last(internal::Access::column(tbl, c));
+        if (nullptr == mark) {
+            fprintf(stderr, "[kdb+] No last value of column %s in snapshot %s.\n", col, path);
+            return Result(nullptr);
+        }
+        Result rows = kcon.sync(delta, {Result(mark, false)});
+        K y = internal::Access::k(rows);
+        if (nullptr == y) {
+            return Result(nullptr);
+        } else if (y->t != 98 || kK(y->k)[0]->n != tbl.ncol()) {
+            fprintf(stderr, "[kdb+] Rows of %s do not match snapshot %s.\n", delta, path);
+            return Result(nullptr);
+        } else if (0 == kK(kK(y->k)[1])[0]->n) {
+            return snap;
+        }
+
+        K old_names = kK(x->k)[0], new_names = kK(y->k)[0];
+        for (long long i = 0; i < tbl.ncol(); ++i) {
+            if (kS(new_names)[i] != kS(old_names)[i] || internal::Access::column(tbl, i)->t != kK(kK(y->k)[1])[i]->t) {
+                fprintf(stderr, "[kdb+] Columns of %s do not match snapshot %s.\n", delta, path);
+                return Result(nullptr);
+            }
+        }
+
+        std::vector<S> names;
+        std::vector<K> cols;
+        for (long long i = 0; i < tbl.ncol(); ++i) {
+            names.push_back(kS(old_names)[i]);
+            cols.push_back(internal::concat(internal::Access::column(tbl, i), kK(kK(y->k)[1])[i]));
+        }
+        Result res(internal::make_table(names, cols), false);
+        save_snapshot(res, path);
+        return res;
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @brief   Local snapshots of results in kdb+ IPC format, for a fast warm start
+ *
+ * @file    kdb_snapshot.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_SNAPSHOT_H__
+#define __KDB_SNAPSHOT_H__
+
+#include "kdb_connector.h"
+#include "kdb_result.h"
+
+namespace kdb {
+
+    /**
+     * @brief       Save a result to a file: a 64-byte header with a format version, the size
+     *              and a checksum of the data, then the result serialized as a kdb+ IPC message.
+     *              The file is written beside the target and renamed over it, so a crash never
+     *              leaves a partial snapshot.
+     *
+     * @param res   any result, e.g., a reference table fetched at start
+     * @param path  file
+     * @return false    serialization or I/O error
+     */
+    bool save_snapshot(const Result &res, const char *path);
+
+    /**
+     * @brief       Load a snapshot. The file is mapped and decoded in parallel straight from
+     *              the page cache into the buffers of the result, without reading it into an
+     *              intermediate buffer.
+     *
+     * @param path  file written by save_snapshot
+     * @param verify    check the checksum, which reads the whole file once more
+     * @param max_threads   0 for the number of hardware threads
+     * @return Result   the saved result, or Result(nullptr) if missing, of another version or corrupt
+     */
+    Result load_snapshot(const char *path, bool verify = true, unsigned max_threads = 0);
+
+    /**
+     * @brief       Bring a snapshot of an append-only table up to date: load it, fetch the
+     *              rows newer than its last row, append them and save the snapshot again.
+     *              Without a valid snapshot, the whole table is fetched.
+     *
+     *              refresh_snapshot(kcon, "ref.snap", "select from ref", "{select from ref where id>x}", "id");
+     *
+     * @param kcon  connection
+     * @param path  snapshot file
+     * @param full  query for the whole table
+     * @param delta function of the last value of col, returning the rows after it
+     * @param col   column in ascending order, e.g., an id or a time
+     * @return Result   the refreshed table, or Result(nullptr) on error
+     */
+    Result refresh_snapshot(Connector &kcon, const char *path, const char *full, const char *delta, const char *col);
+}
+
+#endif // __KDB_SNAPSHOT_H__
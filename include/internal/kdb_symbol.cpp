@@ -0,0 +1,115 @@
+/**
+ * @brief   Symbol interning with dense integer IDs
+ *
+ * @file    kdb_symbol.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <cstring>
+#include "kdb_symbol.h"
+
+namespace kdb {
+
+    static inline std::size_t hash_ptr(const char *p) {
+        return static_cast<std::size_t>((reinterpret_cast<uintptr_t>(p) >> 3) * 0x9E3779B97F4A7C15ULL >> 16);
+    }
+
+    SymbolTable &SymbolTable::global() {
+        static SymbolTable table;
+        return table;
+    }
+
+    long long SymbolTable::probe(const char *sym) const {
+        if (slots_.empty()) {
+            return -1;
+        }
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = hash_ptr(sym) & mask; slots_[i].sym; i = (i + 1) & mask) {
+            if (slots_[i].sym == sym) {
+                return slots_[i].id;
+            }
+        }
+        return -1;
+    }
+
+    void SymbolTable::put(const char *sym, uint32_t id) {
+        // Keep load factor under 1/2
+        if ((used_ + 1) * 2 > slots_.size()) {
+            std::vector<Slot> old(slots_.empty() ? 64 : slots_.size() * 2, Slot{nullptr, 0});
+            old.swap(slots_);
+            used_ = 0;
+            for (auto const &slot : old) {
+                if (slot.sym) {
+                    put(slot.sym, slot.id);
+                }
+            }
+        }
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = hash_ptr(sym) & mask;
+        while (slots_[i].sym) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = Slot{sym, id};
+        ++used_;
+    }
+
+    // Caller holds the lock. Only pooled pointers are keys: a caller-owned buffer may hold
+    // another symbol by the next call.
+    uint32_t SymbolTable::insert(const char *pooled) {
+        long long id = probe(pooled);
+        if (id < 0) {
+            id = static_cast<long long>(syms_.size());
+            syms_.emplace_back(pooled, std::strlen(pooled));
+            put(pooled, static_cast<uint32_t>(id));
+        }
+        return static_cast<uint32_t>(id);
+    }
+
+    uint32_t SymbolTable::intern(const char *sym) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return insert(ss(const_cast<S>(sym)));
+    }
+
+    uint32_t SymbolTable::intern(std::string_view sym) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return insert(sn(const_cast<S>(sym.data()), static_cast<I>(sym.size())));
+    }
+
+    void SymbolTable::intern(const Vector<Type::Symbol> &syms, uint32_t *out) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        const char *prev = nullptr;
+        uint32_t prev_id = 0;
+        for (long long i = 0; i < syms.size(); ++i) {
+            const char *sym = syms[i];
+            if (sym != prev) {
+                // Tick data often repeats the same symbol in runs
+                prev = sym;
+                prev_id = insert(sym);
+            }
+            out[i] = prev_id;
+        }
+    }
+
+    std::vector<uint32_t> SymbolTable::intern(const Vector<Type::Symbol> &syms) {
+        std::vector<uint32_t> ids(static_cast<std::size_t>(syms.size()));
+        intern(syms, ids.data());
+        return ids;
+    }
+
+    long long SymbolTable::find(std::string_view sym) const {
+        const char *pooled = sn(const_cast<S>(sym.data()), static_cast<I>(sym.size()));
+        std::lock_guard<std::mutex> lock(mtx_);
+        return probe(pooled);
+    }
+
+    std::string_view SymbolTable::lookup(uint32_t id) const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return syms_[id];
+    }
+
+    std::size_t SymbolTable::size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return syms_.size();
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @brief   Symbol interning with dense integer IDs
+ *
+ * @file    kdb_symbol.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_SYMBOL_H__
+#define __KDB_SYMBOL_H__
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "kdb_type.h"
+#include "kdb_vector.h"
+
+namespace kdb {
+
+    /**
+     * @brief   Maps kdb+ symbols to dense uint32_t IDs, starting from 0.
+     *
+     *          Symbols decoded by c.o are interned in its process-wide pool, so a symbol
+     *          is identified by its pointer and an ID never changes once assigned, no
+     *          matter which message the symbol came from. All methods are thread-safe.
+     */
+    class SymbolTable {
+    public:
+        SymbolTable() = default;
+        SymbolTable(const SymbolTable &) = delete;
+        SymbolTable & operator = (const SymbolTable &) = delete;
+
+        /**
+         * @brief   Process-wide symbol table
+         *
+         * @return  SymbolTable&
+         */
+        static SymbolTable &global();
+
+        /**
+         * @brief       Get the ID of a symbol, assigning a new one if unseen. The symbol is
+         *              pooled with ss() first, so sym may be a reused buffer.
+         *
+         * @param sym   null-terminated symbol
+         * @return uint32_t
+         */
+        uint32_t intern(const char *sym);
+
+        /**
+         * @brief       Get the ID of a symbol, assigning a new one if unseen
+         *
+         * @param sym   symbol
+         * @return uint32_t
+         */
+        uint32_t intern(std::string_view sym);
+
+        /**
+         * @brief       Convert a whole symbol vector to IDs in one pass. The symbols are keyed
+         *              by pointer as they are: those of vectors from kdb+ or built with ss() are
+         *              pooled already.
+         *
+         * @param syms  symbol vector, e.g., a sym column
+         * @param out   output buffer of at least syms.size() elements
+         */
+        void intern(const Vector<Type::Symbol> &syms, uint32_t *out);
+
+        /**
+         * @brief       Convert a whole symbol vector to IDs in one pass
+         *
+         * @param syms  symbol vector, e.g., a sym column
+         * @return std::vector<uint32_t>
+         */
+        std::vector<uint32_t> intern(const Vector<Type::Symbol> &syms);
+
+        /**
+         * @brief       Get the ID of a symbol without assigning a new one
+         *
+         * @param sym   symbol
+         * @return long long    ID, or -1 if the symbol has not been interned
+         */
+        long long find(std::string_view sym) const;
+
+        /**
+         * @brief       Get the symbol of an ID. Undefined behavior if id >= size().
+         *
+         * @param id    symbol ID
+         * @return std::string_view    view into the c.o symbol pool, valid for the process lifetime
+         */
+        std::string_view lookup(uint32_t id) const;
+
+        /**
+         * @brief   Number of interned symbols
+         */
+        std::size_t size() const;
+
+    private:
+        struct Slot {
+            const char *sym;
+            uint32_t id;
+        };
+
+        uint32_t insert(const char *pooled);
+        long long probe(const char *sym) const;
+        void put(const char *sym, uint32_t id);
+
+        mutable std::mutex mtx_;
+        std::vector<Slot> slots_;               // open addressing, keyed by interned pointer
+        std::size_t used_ = 0;                  // occupied slots
+        std::vector<std::string_view> syms_;    // indexed by ID
+    };
+}
+
+#endif // __KDB_SYMBOL_H__
@@ -7,6 +7,7 @@
  */
 
 #include "kdb_type.h"
+#include "kdb_memory.h"
 #include "kdb_table.h"
 
 namespace kdb {
@@ -14,19 +15,52 @@ namespace kdb {
                                     n_rows_(kK(kK(res_->k)[1])[0]->n),
                                     n_cols_(kK(res_->k)[0]->n) {
         if (res_) {
-            r1(res_);
+            internal::inc_ref(res_);
+        }
+    }
+
+    Table::Table(const Table &t) : res_(t.res_), n_rows_(t.n_rows_), n_cols_(t.n_cols_) {
+        if (res_) {
+            internal::inc_ref(res_);
         }
     }
 
     Table::~Table() {
         if (res_) {
-            r0(res_);
+            internal::dec_ref(res_);
             res_ = nullptr;
         }
     }
 
+    Table & Table::operator = (const Table &t) {
+        if (this != &t) {
+            if (t.res_) {
+                internal::inc_ref(t.res_);
+            }
+            if (res_) {
+                internal::dec_ref(res_);
+            }
+            res_ = t.res_;
+            n_rows_ = t.n_rows_;
+            n_cols_ = t.n_cols_;
+        }
+        return *this;
+    }
+
     Vector<Type::Symbol> Table::get_header() {
         return Result(kK(res_->k)[0]).get_vector<Type::Symbol>();
     }
 
+    long long Table::find_column(const char *name) const {
+        // Column names are pooled symbols
+        S sym = ss(const_cast<S>(name));
+        K header = kK(res_->k)[0];
+        for (long long col = 0; col < header->n; ++col) {
+            if (kS(header)[col] == sym) {
+                return col;
+            }
+        }
+        return -1;
+    }
+
 }
@@ -19,11 +19,17 @@
 #include "kdb_vector.h"
 
 namespace kdb {
+    class KeyIndex;
 
     class Table {
     public:
         Table(const Result &r);
+        Table(const Table &t);
         ~Table();
+        Table & operator = (const Table &t);
+
+        friend class kdb::KeyIndex;
+        friend struct internal::Access;
 
         /**
          * @brief   Number of columns
@@ -41,6 +47,14 @@ namespace kdb {
          * @return Vector<Type::Symbol> 
          */
         Vector<Type::Symbol> get_header();
+
+        /**
+         * @brief       Find a column by name
+         * 
+         * @param name  column name
+         * @return long long    column index, or -1 if there is no such column
+         */
+        long long find_column(const char *name) const;
         
         /**
          * @brief Get the column object as a vector
@@ -75,6 +89,8 @@ namespace kdb {
         T get(long long row, long long col) const;
 
     private:
+        inline K column(long long col) const { return kK(kK(res_->k)[1])[col]; }
+
         K res_;
         long long n_rows_; // number of rows
         long long n_cols_; // number of columns
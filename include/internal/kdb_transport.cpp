@@ -0,0 +1,345 @@
+/**
+ * @brief   Local transports to kdb+: Unix domain sockets and shared memory
+ *
+ * @file    kdb_transport.cpp
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "kdb_ipc.h"
+#include "kdb_transport.h"
+
+namespace kdb {
+    namespace internal {
+
+        namespace {
+
+            // q listens on the abstract socket "\0/tmp/kx.port" on Linux, or on the file
+            // /tmp/kx.port elsewhere or when QUDSPATH is set
+            int open_unix(int port, bool abstract) {
+                int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                if (fd < 0) {
+                    return -1;
+                }
+                sockaddr_un addr;
+                std::memset(&addr, 0, sizeof(addr));
+                addr.sun_family = AF_UNIX;
+                char *path = addr.sun_path + (abstract ? 1 : 0);
+                int len = snprintf(path, sizeof(addr.sun_path) - 1, "/tmp/kx.%d", port);
+                socklen_t size = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + len + (abstract ? 1 : 0));
+                if (connect(fd, reinterpret_cast<sockaddr *>(&addr), size) < 0) {
+                    close(fd);
+                    return -1;
+                }
+                return fd;
+            }
+        }
+
+        int connect_unix(int port, const char *usr_pwd, int timeout) {
+            int fd = open_unix(port, true);
+            if (fd < 0) {
+                fd = open_unix(port, false);
+            }
+            if (fd < 0) {
+                return -1;
+            }
+
+            // Same login as over TCP: "username:password", capability 3, null-terminated
+            std::string login(usr_pwd == nullptr ? "" : usr_pwd);
+            login.push_back('\3');
+            login.push_back('\0');
+            if (timeout > 0) {
+                timeval tv = {timeout / 1000, timeout % 1000 * 1000};
+                setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            }
+            unsigned char capability;
+            if (!write_all(fd, login.data(), login.size())) {
+                close(fd);
+                return -1;
+            } else if (!read_all(fd, &capability, 1)) {
+                close(fd);
+                return 0;   // q closes the connection on wrong credentials
+            }
+            timeval none = {0, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &none, sizeof(none));
+            return fd;
+        }
+
+        struct ShmChannel::Ring {
+            alignas(64) std::atomic<uint64_t> head;     // bytes written, by the producer
+            alignas(64) std::atomic<uint64_t> tail;     // bytes read, by the consumer
+            alignas(64) std::atomic<uint32_t> seq;      // futex word, bumped on every head or tail move
+            std::atomic<uint32_t> waiters;
+        };
+
+        struct ShmChannel::Control {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t capacity;
+            std::atomic<uint32_t> server;       // 1 while the server is up
+            std::atomic<uint32_t> client;       // 0 none, 1 attached, 2 attaching
+            Ring rings[2];                      // client to server, server to client
+        };
+
+        namespace {
+
+            constexpr uint32_t kMagic = 0x6b646273;    // "kdbs"
+            constexpr int kSpins = 4096;
+
+            inline long futex(std::atomic<uint32_t> *word, int op, uint32_t val, const timespec *ts) {
+                return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, val, ts, nullptr, 0);
+            }
+
+            inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            }
+        }
+
+        static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                      "shared memory rings need lock-free atomics");
+
+        // Wait until ready() holds, the peer goes away (if checked) or the timeout expires
+        template<typename Ready, typename Alive>
+        static bool wait(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiters, Ready ready, Alive alive, int timeout) {
+            // Spinning only helps when the peer runs on another core
+            static const int spins = std::thread::hardware_concurrency() > 1 ? kSpins : 0;
+            for (int i = 0; i < spins; ++i) {
+                if (ready()) {
+                    return true;
+                }
+                cpu_relax();
+            }
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+            for (;;) {
+                uint32_t s = seq.load();
+                if (ready()) {
+                    return true;
+                } else if (!alive()) {
+                    return false;
+                }
+                // Sleep in slices so that a peer that died without notifying is noticed
+                long long ms = 100;
+                if (timeout >= 0) {
+                    ms = std::min<long long>(ms, std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now()).count());
+                    if (ms <= 0) {
+                        return ready();
+                    }
+                }
+                timespec ts = {static_cast<time_t>(ms / 1000), static_cast<long>(ms % 1000 * 1000000)};
+                ++waiters;
+                futex(&seq, FUTEX_WAIT, s, &ts);
+                --waiters;
+            }
+        }
+
+        static inline void notify(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiters) {
+            ++seq;
+            if (waiters.load() > 0) {
+                futex(&seq, FUTEX_WAKE, INT_MAX, nullptr);
+            }
+        }
+
+        ShmChannel::ShmChannel(const std::string &name, bool create, size_t capacity) : name_(name), server_(create) {
+            size_t header = (sizeof(Control) + 63) & ~size_t(63);
+            int fd;
+            if (create) {
+                shm_unlink(name.c_str());   // stale segment of a crashed server
+                fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+                if (fd < 0 || ftruncate(fd, static_cast<off_t>(header + 2 * capacity)) < 0) {
+                    fprintf(stderr, "[kdb+] Failed to create shared memory %s.\n", name.c_str());
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                    return;
+                }
+                mapped_ = header + 2 * capacity;
+            } else {
+                struct stat st;
+                fd = shm_open(name.c_str(), O_RDWR, 0);
+                if (fd < 0 || fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < header) {
+                    fprintf(stderr, "[kdb+] Failed to open shared memory %s.\n", name.c_str());
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                    return;
+                }
+                mapped_ = static_cast<size_t>(st.st_size);
+            }
+
+            void *addr = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (MAP_FAILED == addr) {
+                fprintf(stderr, "[kdb+] Failed to map shared memory %s.\n", name.c_str());
+                return;
+            }
+
+            Control *control = static_cast<Control *>(addr);
+            if (create) {
+                control = new (addr) Control();
+                control->magic = kMagic;
+                control->version = 1;
+                control->capacity = capacity;
+                control->server = 1;
+            } else {
+                uint32_t none = 0;
+                if (control->magic != kMagic || 1 != control->server || header + 2 * control->capacity > mapped_
+                    || !control->client.compare_exchange_strong(none, 2)) {
+                    fprintf(stderr, "[kdb+] Shared memory %s is not served or already in use.\n", name.c_str());
+                    munmap(addr, mapped_);
+                    return;
+                }
+                // Start from empty rings, whatever a previous client left
+                for (Ring &ring : control->rings) {
+                    ring.head = 0;
+                    ring.tail = 0;
+                }
+                control->client = 1;
+            }
+
+            control_ = control;
+            unsigned char *data = static_cast<unsigned char *>(addr) + header;
+            in_ = &control->rings[create ? 0 : 1];
+            out_ = &control->rings[create ? 1 : 0];
+            in_data_ = data + (create ? 0 : control->capacity);
+            out_data_ = data + (create ? control->capacity : 0);
+        }
+
+        ShmChannel::~ShmChannel() {
+            if (nullptr == control_) {
+                return;
+            }
+            (server_ ? control_->server : control_->client) = 0;
+            for (Ring &ring : control_->rings) {
+                notify(ring.seq, ring.waiters);
+            }
+            munmap(control_, mapped_);
+            if (server_) {
+                shm_unlink(name_.c_str());
+            }
+        }
+
+        bool ShmChannel::attached() const {
+            return control_ != nullptr && 1 == control_->client;
+        }
+
+        bool ShmChannel::write(const void *buf, size_t n) {
+            const unsigned char *p = static_cast<const unsigned char *>(buf);
+            const uint64_t capacity = control_->capacity;
+            auto alive = [this]() { return !closed_ && (server_ ? 1 == control_->client : 1 == control_->server); };
+            while (n > 0) {
+                uint64_t head = out_->head.load(std::memory_order_relaxed);
+                auto room = [&]() { return head - out_->tail.load(std::memory_order_acquire) < capacity; };
+                if (!room() && !wait(out_->seq, out_->waiters, room, alive, -1)) {
+                    return false;
+                }
+                uint64_t space = capacity - (head - out_->tail.load(std::memory_order_acquire));
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>({n, space, capacity - head % capacity}));
+                std::memcpy(out_data_ + head % capacity, p, chunk);
+                out_->head.store(head + chunk, std::memory_order_release);
+                notify(out_->seq, out_->waiters);
+                p += chunk;
+                n -= chunk;
+            }
+            return true;
+        }
+
+        bool ShmChannel::read(void *buf, size_t n, int timeout) {
+            unsigned char *p = static_cast<unsigned char *>(buf);
+            const uint64_t capacity = control_->capacity;
+            auto alive = [this]() { return !closed_ && (server_ ? 1 == control_->client : 1 == control_->server); };
+            while (n > 0) {
+                uint64_t tail = in_->tail.load(std::memory_order_relaxed);
+                auto ready = [&]() { return in_->head.load(std::memory_order_acquire) != tail; };
+                if (!ready() && !wait(in_->seq, in_->waiters, ready, alive, timeout)) {
+                    return false;
+                }
+                uint64_t available = in_->head.load(std::memory_order_acquire) - tail;
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>({n, available, capacity - tail % capacity}));
+                std::memcpy(p, in_data_ + tail % capacity, chunk);
+                in_->tail.store(tail + chunk, std::memory_order_release);
+                notify(in_->seq, in_->waiters);
+                p += chunk;
+                n -= chunk;
+            }
+            return true;
+        }
+
+        bool ShmChannel::readable(int timeout) {
+            auto ready = [this]() {
+                return in_->head.load(std::memory_order_acquire) != in_->tail.load(std::memory_order_relaxed);
+            };
+            // A server keeps waiting for a client to attach
+            auto alive = [this]() { return !closed_ && (server_ || 1 == control_->server); };
+            return wait(in_->seq, in_->waiters, ready, alive, timeout);
+        }
+
+        void ShmChannel::shutdown() {
+            if (nullptr == control_) {
+                return;
+            }
+            closed_ = true;
+            for (Ring &ring : control_->rings) {
+                notify(ring.seq, ring.waiters);
+            }
+        }
+    }
+
+    ShmServer::ShmServer(int port, size_t capacity) : channel_("/kx." + std::to_string(port), true, capacity) {}
+
+    bool ShmServer::serve(const Handler &handler, int timeout) {
+        if (!channel_.valid()) {
+            return false;
+        } else if (!channel_.readable(timeout)) {
+            return true;
+        }
+
+        internal::Header header;
+        K msg = internal::read_message([this](void *buf, size_t n) { return channel_.read(buf, n, 1000); }, header);
+        if (nullptr == msg) {
+            return true;    // client went away mid-message
+        }
+        K request = internal::decode(msg, SIZE_MAX);
+        r0(msg);
+        if (nullptr == request) {
+            fprintf(stderr, "[kdb+] Malformed message on shared memory.\n");
+            return true;
+        }
+
+        K reply = handler(request);
+        r0(request);
+        if (internal::kSync == header.type) {
+            if (nullptr == reply) {
+                reply = ka(101);    // generic null, ::
+                reply->g = 0;
+            }
+            K response = internal::encode(reply, internal::kResponse);
+            if (response != nullptr) {
+                channel_.write(kG(response), static_cast<size_t>(response->n));
+                r0(response);
+            }
+        }
+        if (reply != nullptr) {
+            r0(reply);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * @brief   Local transports to kdb+: Unix domain sockets and shared memory
+ *
+ * @file    kdb_transport.h
+ * @author  Cody Feng <cody.feng"AT"outlook.com>
+ * @date    2026-10-18
+ */
+
+#ifndef __KDB_TRANSPORT_H__
+#define __KDB_TRANSPORT_H__
+
+#ifndef KXVER
+#define KXVER 3
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "../external/k.h"
+
+namespace kdb {
+
+    /**
+     * @brief   How a Connector reaches kdb+
+     */
+    enum class Transport {
+        TCP,            // khpu/khpun, any host
+        Unix,           // Unix domain socket of a local q process, i.e., hopen `:unix://port
+        SharedMemory    // experimental: shared memory ring to a local ShmServer
+    };
+
+    namespace internal {
+
+        /**
+         * @brief       Connect to the Unix domain socket of a local q process and log in
+         *
+         * @param port      port q listens on, i.e., q -p port
+         * @param usr_pwd   username:password
+         * @param timeout   in milliseconds, for the login
+         * @return int  socket, 0 if the credentials were rejected, -1 if the connection failed
+         */
+        int connect_unix(int port, const char *usr_pwd, int timeout);
+
+        /**
+         * @brief   A pair of single-producer single-consumer byte rings in a POSIX shared
+         *          memory segment, one per direction, carrying IPC messages as they would
+         *          travel on a socket. Waiting spins briefly, then sleeps on a futex.
+         */
+        class ShmChannel {
+        public:
+            /**
+             * @brief       Create (server) or open (client) a segment
+             *
+             * @param name      shared memory name, e.g., /kx.5000
+             * @param create    true for the server
+             * @param capacity  bytes per ring, server only
+             */
+            ShmChannel(const std::string &name, bool create, size_t capacity=1 << 20);
+            ~ShmChannel();
+
+            ShmChannel(const ShmChannel &) = delete;
+            ShmChannel &operator=(const ShmChannel &) = delete;
+
+            inline bool valid() const { return control_ != nullptr; }
+
+            /**
+             * @brief   Write all bytes, waiting for room. false if the peer is gone.
+             */
+            bool write(const void *buf, size_t n);
+
+            /**
+             * @brief   Read exactly n bytes. false if the peer is gone or on timeout.
+             *
+             * @param timeout   in milliseconds, -1 to wait indefinitely
+             */
+            bool read(void *buf, size_t n, int timeout=-1);
+
+            /**
+             * @brief   Wait until there is something to read
+             *
+             * @param timeout   in milliseconds, -1 to wait indefinitely
+             */
+            bool readable(int timeout);
+
+            /**
+             * @brief   Make pending and later reads and writes fail at once, e.g., to stop a
+             *          writer waiting for room on a hung peer
+             */
+            void shutdown();
+
+            /**
+             * @brief   Whether a client is attached, server only
+             */
+            bool attached() const;
+
+        private:
+            struct Ring;
+            struct Control;
+
+            Control *control_ = nullptr;
+            size_t mapped_ = 0;
+            std::string name_;
+            bool server_ = false;
+            std::atomic<bool> closed_{false};
+            Ring *in_ = nullptr;
+            Ring *out_ = nullptr;
+            unsigned char *in_data_ = nullptr;
+            unsigned char *out_data_ = nullptr;
+        };
+    }
+
+    /**
+     * @brief   Experimental peer of Transport::SharedMemory: serves the messages of one local
+     *          Connector through a handler, e.g., a C++ process publishing its data to
+     *          co-located clients without a socket round trip.
+     */
+    class ShmServer {
+    public:
+        /**
+         * @brief       Handles a request and returns a new reply, or nullptr for none.
+         *              The request is released after the call.
+         */
+        typedef std::function<K(K request)> Handler;
+
+        /**
+         * @param port      clients connect with Transport::SharedMemory on this port
+         * @param capacity  bytes per ring
+         */
+        ShmServer(int port, size_t capacity=1 << 20);
+
+        inline bool valid() const { return channel_.valid(); }
+
+        /**
+         * @brief Serve one message, replying to sync messages
+         *
+         * @param handler   request handler
+         * @param timeout   in milliseconds, -1 to wait indefinitely
+         * @return true     served a message or timed out
+         * @return false    transport error
+         */
+        bool serve(const Handler &handler, int timeout=1000);
+
+    private:
+        internal::ShmChannel channel_;
+    };
+}
+
+#endif // __KDB_TRANSPORT_H__
@@ -51,6 +51,18 @@ namespace kdb {
         Unknown, Atom, Vector, List, Dictionary, Table, KeyedTable
     };
 
+    /**
+     * @brief   kdb+ attributes of a vector, a table column in particular
+     * @see     https://code.kx.com/q/ref/set-attribute/
+     */
+    enum class Attribute {
+        None = 0,
+        Sorted = 1,     // s#
+        Unique = 2,     // u#
+        Parted = 3,     // p#
+        Grouped = 4     // g#
+    };
+
     /**
      * @brief       Mapping from kdb+ data types to c types.
      * @tparam T    enum class Type from above
@@ -13,18 +13,47 @@
 #define KXVER 3
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "../external/k.h"
 #include "kdb_type.h"
+#include "kdb_memory.h"
 
 namespace kdb {
+    namespace internal {
+        struct Access;
+    }
+
     template<Type T>
     class Vector {
     public:
-        Vector(K res, long long size) : res_(res), size_(size) { if (res_) { r1(res_); }};
-        ~Vector() { if (res_) r0(res_); };
+        Vector(K res, long long size) : res_(res), size_(size) { if (res_) { internal::inc_ref(res_); }};
+        Vector(const Vector &v) : res_(v.res_), size_(v.size_), offset_(v.offset_), index_(v.index_) { if (res_) { internal::inc_ref(res_); }};
+        Vector(Vector &&v) noexcept : res_(v.res_), size_(v.size_), offset_(v.offset_), index_(std::move(v.index_)) { v.res_ = nullptr; v.size_ = 0; };
+        ~Vector() { if (res_) internal::dec_ref(res_); };
+
+        Vector & operator = (const Vector &v) {
+            if (this != &v) {
+                if (v.res_) internal::inc_ref(v.res_);
+                if (res_) internal::dec_ref(res_);
+                res_ = v.res_;
+                size_ = v.size_;
+                offset_ = v.offset_;
+                index_ = v.index_;
+            }
+            return *this;
+        }
+
         inline long long size() const { return size_; }
 
+        typedef typename c_type<T>::type value_type;
         typedef typename c_type<T>::type & reference;
         typedef typename c_type<T>::type const & const_reference;
         typedef typename c_type<T>::type * iterator;
@@ -32,20 +61,20 @@ namespace kdb {
         typedef std::reverse_iterator<iterator> reverse_iterator;
         typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        reference operator[](const long long i) { return reinterpret_cast<iterator>(res_->G0)[i]; }
-        const_reference operator[](const long long i) const { return reinterpret_cast<iterator>(res_->G0)[i]; }
+        reference operator[](const long long i) { return data()[i]; }
+        const_reference operator[](const long long i) const { return data()[i]; }
 
-        iterator begin() { return reinterpret_cast<iterator>(res_->G0); }
-        iterator end() { return reinterpret_cast<iterator>(res_->G0) + size_; }
+        iterator begin() { return data(); }
+        iterator end() { return data() + size_; }
 
-        const_iterator cbegin() { return reinterpret_cast<const_iterator>(res_->G0); }
-        const_iterator cend() { return reinterpret_cast<const_iterator>(res_->G0) + size_; }
+        const_iterator cbegin() { return data(); }
+        const_iterator cend() { return data() + size_; }
 
-        const_iterator begin() const { return reinterpret_cast<iterator>(res_->G0); }
-        const_iterator end() const { return reinterpret_cast<iterator>(res_->G0) + size_; }
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + size_; }
 
-        const_iterator cbegin() const { return reinterpret_cast<const_iterator>(res_->G0); }
-        const_iterator cend()   const { return reinterpret_cast<const_iterator>(res_->G0) + size_; }
+        const_iterator cbegin() const { return data(); }
+        const_iterator cend()   const { return data() + size_; }
 
         reverse_iterator rbegin() { return reverse_iterator(end()); }
         reverse_iterator rend()   { return reverse_iterator(begin()); }
@@ -59,10 +88,254 @@ namespace kdb {
         const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
         const_reverse_iterator crend()   const { return const_reverse_iterator(begin()); }
 
+        /**
+         * @brief       View of elements [begin, end), sharing the data of this vector, e.g., a
+         *              window of a tick vector. The bounds are clamped to the vector.
+         *
+         * @param begin first index
+         * @param end   one past the last index
+         * @return Vector   slice with its own lookup index
+         */
+        Vector slice(long long begin, long long end) const {
+            begin = std::max(0LL, std::min(begin, size_));
+            end = std::max(begin, std::min(end, size_));
+            Vector v(res_, end - begin);
+            v.offset_ = offset_ + begin;
+            return v;
+        }
+
+        /**
+         * @brief   Attribute set on the vector by kdb+, e.g., s# on a time column
+         * 
+         * @return  kdb::Attribute 
+         */
+        inline Attribute attribute() const { return static_cast<Attribute>(res_->u); }
+
+        /**
+         * @brief       Index of the first occurrence of a value.
+         *              Binary search if sorted, hash lookup if unique, parted or grouped, linear otherwise.
+         * 
+         * @param v     value
+         * @return long long    index, or -1 if not found
+         */
+        long long find(value_type v) const;
+
+        /**
+         * @brief       Range [first, last) of indexes equal to a value.
+         *              Binary search if sorted, hash lookup if unique or parted. For other vectors,
+         *              the run of equal values starting at the first occurrence.
+         * 
+         * @param v     value
+         * @return std::pair<long long, long long>     empty range at the insertion point if not found
+         */
+        std::pair<long long, long long> equal_range(value_type v) const;
+
+        /**
+         * @brief       All indexes equal to a value, in ascending order.
+         *              Hash lookup if grouped, unique or parted, binary search if sorted, linear otherwise.
+         * 
+         * @param v     value
+         * @return std::vector<long long> 
+         */
+        std::vector<long long> where(value_type v) const;
+
+        /**
+         * @brief       As-of search like q bin: index of the last element <= v.
+         *              Undefined behavior if the vector is not in ascending order.
+         * 
+         * @param v     value
+         * @return long long    index, or -1 if all elements are greater than v
+         */
+        long long bin(value_type v) const;
+
+        /**
+         * @brief       Range [first, last) of indexes with lo <= element <= hi, like q within,
+         *              e.g., a time slice of a tick vector. Undefined behavior if the vector is
+         *              not in ascending order.
+         * 
+         * @param lo    lower bound, inclusive
+         * @param hi    upper bound, inclusive
+         * @return std::pair<long long, long long> 
+         */
+        std::pair<long long, long long> within(value_type lo, value_type hi) const;
+
+        /**
+         * @brief   Build the hash index of a unique, parted or grouped vector. Called by the
+         *          lookups if not built yet; call it before looking up from several threads.
+         *          The index is shared by copies of this Vector.
+         */
+        void build_index() const;
+
+        friend struct internal::Access;
+
     private:
+        inline iterator data() const { return reinterpret_cast<iterator>(res_->G0) + offset_; }
+
+        // kdb+ order: nulls first, symbols lexicographic
+        static bool less(value_type a, value_type b) {
+            if constexpr (T == Type::Symbol) {
+                return std::strcmp(a, b) < 0;
+            } else if constexpr (std::is_floating_point<value_type>::value) {
+                return a != a ? b == b : (b == b && a < b);
+            } else {
+                return a < b;
+            }
+        }
+
+        static bool equal(value_type a, value_type b) {
+            if constexpr (std::is_floating_point<value_type>::value) {
+                return a == b || (a != a && b != b);
+            } else {
+                // Symbols are pooled, see pool()
+                return a == b;
+            }
+        }
+
+        static value_type pool(value_type v) {
+            if constexpr (T == Type::Symbol) {
+                return ss(v);
+            } else {
+                return v;
+            }
+        }
+
+        struct Hash {
+            std::size_t operator()(value_type v) const {
+                if constexpr (std::is_floating_point<value_type>::value) {
+                    if (v != v) {
+                        return 0;
+                    }
+                }
+                return std::hash<value_type>()(v);
+            }
+        };
+
+        struct Equal {
+            bool operator()(value_type a, value_type b) const { return Vector::equal(a, b); }
+        };
+
+        struct Index {
+            std::unordered_map<value_type, std::pair<long long, long long>, Hash, Equal> ranges;    // u# p#
+            std::unordered_map<value_type, std::vector<long long>, Hash, Equal> groups;             // g#
+        };
+
         K res_;
         long long size_;
+        long long offset_ = 0;      // first element, for slices
+        mutable std::shared_ptr<Index> index_;
     };
+
+    template<Type T>
+    void Vector<T>::build_index() const {
+        if (index_) {
+            return;
+        }
+        auto index = std::make_shared<Index>();
+        const_iterator data = begin();
+        if (attribute() == Attribute::Grouped) {
+            for (long long i = 0; i < size_; ++i) {
+                index->groups[data[i]].push_back(i);
+            }
+        } else {
+            for (long long i = 0; i < size_; ++i) {
+                auto it = index->ranges.emplace(data[i], std::make_pair(i, i + 1));
+                it.first->second.second = i + 1;
+            }
+        }
+        index_ = index;
+    }
+
+    template<Type T>
+    long long Vector<T>::find(value_type v) const {
+        v = pool(v);
+        const_iterator first = begin(), last = end();
+        switch (attribute()) {
+        case Attribute::Sorted: {
+            const_iterator it = std::lower_bound(first, last, v, less);
+            return it != last && equal(*it, v) ? it - first : -1;
+        }
+        case Attribute::Unique: case Attribute::Parted: {
+            build_index();
+            auto it = index_->ranges.find(v);
+            return it == index_->ranges.end() ? -1 : it->second.first;
+        }
+        case Attribute::Grouped: {
+            build_index();
+            auto it = index_->groups.find(v);
+            return it == index_->groups.end() ? -1 : it->second.front();
+        }
+        default: {
+            const_iterator it = std::find_if(first, last, [v](value_type x) { return equal(x, v); });
+            return it != last ? it - first : -1;
+        }
+        }
+    }
+
+    template<Type T>
+    std::pair<long long, long long> Vector<T>::equal_range(value_type v) const {
+        v = pool(v);
+        const_iterator first = begin(), last = end();
+        switch (attribute()) {
+        case Attribute::Sorted: {
+            auto range = std::equal_range(first, last, v, less);
+            return std::make_pair(range.first - first, range.second - first);
+        }
+        case Attribute::Unique: case Attribute::Parted: {
+            build_index();
+            auto it = index_->ranges.find(v);
+            return it == index_->ranges.end() ? std::make_pair(size_, size_) : it->second;
+        }
+        default: {
+            long long lo = find(v);
+            if (lo < 0) {
+                return std::make_pair(size_, size_);
+            }
+            long long hi = lo + 1;
+            while (hi < size_ && equal(first[hi], v)) {
+                ++hi;
+            }
+            return std::make_pair(lo, hi);
+        }
+        }
+    }
+
+    template<Type T>
+    std::vector<long long> Vector<T>::where(value_type v) const {
+        v = pool(v);
+        std::vector<long long> indexes;
+        if (attribute() == Attribute::Grouped) {
+            build_index();
+            auto it = index_->groups.find(v);
+            if (it != index_->groups.end()) {
+                indexes = it->second;
+            }
+        } else if (attribute() != Attribute::None) {
+            auto range = equal_range(v);
+            for (long long i = range.first; i < range.second; ++i) {
+                indexes.push_back(i);
+            }
+        } else {
+            const_iterator data = begin();
+            for (long long i = 0; i < size_; ++i) {
+                if (equal(data[i], v)) {
+                    indexes.push_back(i);
+                }
+            }
+        }
+        return indexes;
+    }
+
+    template<Type T>
+    long long Vector<T>::bin(value_type v) const {
+        return (std::upper_bound(begin(), end(), v, less) - begin()) - 1;
+    }
+
+    template<Type T>
+    std::pair<long long, long long> Vector<T>::within(value_type lo, value_type hi) const {
+        const_iterator first = begin(), last = end();
+        const_iterator from = std::lower_bound(first, last, lo, less);
+        return std::make_pair(from - first, std::upper_bound(from, last, hi, less) - first);
+    }
 }
 
 #endif // __KDB_VECTOR_H__
@@ -10,10 +10,27 @@
 #define __KDB_CPP_H__
 
 #include "internal/kdb_type.h"
+#include "internal/kdb_memory.h"
+#include "internal/kdb_transport.h"
+#include "internal/kdb_async.h"
 #include "internal/kdb_connector.h"
 #include "internal/kdb_result.h"
 #include "internal/kdb_vector.h"
 #include "internal/kdb_table.h"
+#include "internal/kdb_dictionary.h"
+#include "internal/kdb_index.h"
+#include "internal/kdb_convert.h"
+#include "internal/kdb_rolling.h"
+#include "internal/kdb_list.h"
+#include "internal/kdb_symbol.h"
+#include "internal/kdb_join.h"
+#include "internal/kdb_remote.h"
+#include "internal/kdb_query.h"
+#include "internal/kdb_select.h"
+#include "internal/kdb_registry.h"
+#include "internal/kdb_relay.h"
+#include "internal/kdb_batch.h"
+#include "internal/kdb_snapshot.h"
 
 
 #endif